@@ -11,7 +11,8 @@ header_tp = ["timestamp", "comm_type", "message_size", "throughput"]
 
 plot_directories = {
     'nodes': 'plots/plots_per_node',
-    'throughput': 'plots/plots_throughput'
+    'throughput': 'plots/plots_throughput',
+    'links': 'plots/plots_links'
 }
 
 def clean_csv(directory, new_directory, filename, log_type="phase"):
@@ -145,6 +146,39 @@ def tp_nodes_bar(dfs_dict):
     plt.savefig(os.path.join(plot_directory, 'average_throughput_by_number_of_nodes.png'))
 
 
+def link_matrix_heatmap(path):
+    matrix_df = pd.read_csv(path, comment='#', dtype={'ru': str})
+    bu_ids = list(matrix_df.columns[2:])
+
+    # low throughput and high latency / error counts are the bad ones, shown red
+    metrics = [('throughput', 'Throughput [Mbit/s]', 'RdYlGn'),
+               ('rtt', 'Avg. RTT [s]', 'RdYlGn_r'),
+               ('errors', 'Errors', 'Reds')]
+
+    fig, axes = plt.subplots(1, len(metrics), figsize=(6 * len(metrics), 5))
+    for ax, (metric, label, colormap) in zip(axes, metrics):
+        metric_df = matrix_df[matrix_df['metric'] == metric]
+        values = metric_df[bu_ids].to_numpy(dtype=float)
+
+        vmin = 0 if metric == 'errors' else None  # no errors anywhere stays white
+        image = ax.imshow(np.ma.masked_invalid(values), cmap=colormap, aspect='auto', interpolation='nearest', vmin=vmin)
+        fig.colorbar(image, ax=ax, label=label)
+
+        ax.set_title(label)
+        ax.set_xlabel('BU')
+        ax.set_ylabel('RU')
+        if len(bu_ids) <= 32:
+            ax.set_xticks(range(len(bu_ids)), bu_ids)
+            ax.set_yticks(range(len(metric_df)), metric_df['ru'])
+
+    plt.tight_layout()
+
+    plot_directory = plot_directories['links']
+    if not os.path.exists(plot_directory):
+        os.makedirs(plot_directory)
+    name = os.path.splitext(os.path.basename(path))[0]
+    plt.savefig(os.path.join(plot_directory, f'link_matrix_{name}.png'))
+
 
 if __name__ == '__main__':
     phase_dfs = {}
@@ -179,3 +213,8 @@ if __name__ == '__main__':
 
     tp_nodes_over_time(sorted_throughput_dfs)
     tp_nodes_bar(sorted_throughput_dfs)
+
+    matrix_directory = 'logs/link_matrix'
+    if os.path.isdir(matrix_directory):
+        for file in sorted(os.listdir(matrix_directory)):
+            link_matrix_heatmap(os.path.join(matrix_directory, file))
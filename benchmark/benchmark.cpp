@@ -49,3 +49,234 @@ std::pair<double, double> Benchmark::calculateThroughput(timespec startTime, tim
 
     return std::make_pair(avgRtt, avgThroughput);
 }
+
+
+void Benchmark::performTrialLogging(std::string commType, std::string messageSize, int phase, std::string ruId, std::string buId,
+                                    const TrialStatistics &stats)
+{
+    std::ofstream outputFile(m_trialsFilepath, std::ios::app);
+    if (outputFile.is_open())
+    {
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
+        {
+            outputFile << "timestamp,comm_type,message_size,phase,ru,bu,trials,outliers,mean,median,stddev,ci95_low,ci95_high\n";
+        }
+
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+        outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                   << commType << ","
+                   << messageSize << ","
+                   << phase << ","
+                   << ruId << ","
+                   << buId << ","
+                   << stats.trials << ","
+                   << stats.outliers << ","
+                   << std::fixed << std::setprecision(1) << stats.mean << ","
+                   << stats.median << ","
+                   << stats.stddev << ","
+                   << stats.ciLow << ","
+                   << stats.ciHigh << "\n";
+
+        outputFile.close();
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_trialsFilepath << std::endl;
+    }
+}
+
+/**
+ * @brief Open the hardware counters, runs continue without them if none are available
+ */
+void Benchmark::enableHardwareCounters()
+{
+    m_hardwareCounters.open();
+
+    if (m_rank == 0)
+        std::cout << "Hardware counters: " << m_hardwareCounters.describe() << std::endl;
+}
+
+/**
+ * @brief Log the hardware counters of this rank over one phase or scan size
+ *
+ * Counters that are unavailable on this rank are left empty.
+ *
+ * @param commType
+ * @param messageSize
+ * @param phase
+ * @param unitId This rank's unit
+ * @param peerId Unit it communicated with
+ * @param bytes Bytes this rank sent or received
+ * @param seconds Communication time the bytes took
+ * @param counters Counter differences over the same time
+ */
+void Benchmark::performCounterLogging(std::string commType, std::string messageSize, int phase, std::string unitId, std::string peerId,
+                                      std::size_t bytes, double seconds, const HardwareCounterValues &counters)
+{
+    std::ofstream outputFile(m_countersFilepath, std::ios::app);
+    if (outputFile.is_open())
+    {
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
+        {
+            outputFile << "timestamp,comm_type,message_size,phase,unit,peer,bytes,throughput,cycles,instructions,ipc,llc_misses,dtlb_misses,cycles_per_byte\n";
+        }
+
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        double throughput = (seconds > 0) ? (bytes * 8.0) / (seconds * 1e6) : 0.0;
+
+        outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                   << commType << ","
+                   << messageSize << ","
+                   << phase << ","
+                   << unitId << ","
+                   << peerId << ","
+                   << bytes << ","
+                   << std::fixed << std::setprecision(1) << throughput << ",";
+
+        for (int counter : {COUNTER_CYCLES, COUNTER_INSTRUCTIONS})
+        {
+            if (counters.available[counter])
+                outputFile << counters.values[counter];
+            outputFile << ",";
+        }
+
+        if (counters.available[COUNTER_CYCLES] && counters.available[COUNTER_INSTRUCTIONS] && counters.values[COUNTER_CYCLES] > 0)
+            outputFile << std::setprecision(3) << double(counters.values[COUNTER_INSTRUCTIONS]) / counters.values[COUNTER_CYCLES];
+        outputFile << ",";
+
+        for (int counter : {COUNTER_LLC_MISSES, COUNTER_DTLB_MISSES})
+        {
+            if (counters.available[counter])
+                outputFile << counters.values[counter];
+            outputFile << ",";
+        }
+
+        if (counters.available[COUNTER_CYCLES] && bytes > 0)
+            outputFile << std::setprecision(3) << double(counters.values[COUNTER_CYCLES]) / bytes;
+        outputFile << "\n";
+
+        outputFile.close();
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_countersFilepath << std::endl;
+    }
+}
+
+/**
+ * @brief Log the CPU this rank spent on one phase or scan size
+ *
+ * CPU cost is process CPU time (user + system) over the bytes and fragments this rank
+ * sent or received, comparable across modes that reach the same throughput.
+ *
+ * @param commType
+ * @param messageSize
+ * @param phase
+ * @param unitId This rank's unit
+ * @param peerId Unit it communicated with
+ * @param bytes Bytes this rank sent or received
+ * @param messages Fragments this rank sent or received
+ * @param seconds Communication time the bytes took
+ * @param usage CPU usage over the same time
+ */
+void Benchmark::performCpuUsageLogging(std::string commType, std::string messageSize, int phase, std::string unitId, std::string peerId,
+                                       std::size_t bytes, std::size_t messages, double seconds, const CpuUsage &usage)
+{
+    std::ofstream outputFile(m_cpuUsageFilepath, std::ios::app);
+    if (outputFile.is_open())
+    {
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
+        {
+            outputFile << "timestamp,comm_type,message_size,phase,unit,peer,bytes,messages,throughput,user_time,system_time,thread_time,"
+                          "cpu_utilisation,voluntary_switches,involuntary_switches,cpu_ns_per_byte,cpu_ns_per_message\n";
+        }
+
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        double throughput = (seconds > 0) ? (bytes * 8.0) / (seconds * 1e6) : 0.0;
+        double utilisation = (seconds > 0) ? usage.processTime() / seconds : 0.0;
+        double nsPerByte = (bytes > 0) ? usage.processTime() * 1e9 / bytes : 0.0;
+        double nsPerMessage = (messages > 0) ? usage.processTime() * 1e9 / messages : 0.0;
+
+        outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                   << commType << ","
+                   << messageSize << ","
+                   << phase << ","
+                   << unitId << ","
+                   << peerId << ","
+                   << bytes << ","
+                   << messages << ","
+                   << std::fixed << std::setprecision(1) << throughput << ","
+                   << std::setprecision(6) << usage.userTime << ","
+                   << usage.systemTime << ","
+                   << usage.threadTime << ","
+                   << std::setprecision(3) << utilisation << ","
+                   << usage.voluntarySwitches << ","
+                   << usage.involuntarySwitches << ","
+                   << nsPerByte << ","
+                   << std::setprecision(1) << nsPerMessage << "\n";
+
+        outputFile.close();
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_cpuUsageFilepath << std::endl;
+    }
+}
+
+/**
+ * @brief Open the transport selected with -X (collective)
+ *
+ * MPI needs nothing, the others connect all RU/BU pairs up front and abort the job if
+ * any pair cannot be connected.
+ */
+void Benchmark::initTransport()
+{
+    if (m_transportSpec == "mpi")
+        return;
+
+#ifdef EB_WITH_UCX
+    if (m_transportSpec == "ucx" || m_transportSpec == "ucx-rma")
+    {
+        std::unique_ptr<UcxTransport> ucx = std::make_unique<UcxTransport>(m_transportSpec == "ucx-rma" ? UCX_RMA : UCX_TAG);
+        if (!ucx->connect(MPI_COMM_WORLD))
+        {
+            if (m_rank == 0)
+                std::cerr << "UCX transport could not connect all RU/BU pairs. Exiting." << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+
+        m_transport = std::move(ucx);
+        return;
+    }
+#else
+    if (m_transportSpec == "ucx" || m_transportSpec == "ucx-rma")
+    {
+        if (m_rank == 0)
+            std::cerr << "Transport " << m_transportSpec << " needs a build with -DEB_WITH_UCX. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+#endif
+
+    if (m_transportSpec != "tcp" && m_transportSpec != "tcp-zerocopy")
+    {
+        if (m_rank == 0)
+            std::cerr << "Invalid transport: " << m_transportSpec << " (mpi, tcp, tcp-zerocopy, ucx or ucx-rma). Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    std::unique_ptr<TcpTransport> tcp = std::make_unique<TcpTransport>(m_transportSpec == "tcp-zerocopy");
+    if (!tcp->connect(MPI_COMM_WORLD))
+    {
+        if (m_rank == 0)
+            std::cerr << "TCP transport could not connect all RU/BU pairs. Exiting." << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    m_transport = std::move(tcp);
+}
@@ -20,9 +20,16 @@
 #include <algorithm>
 #include <functional>
 #include <string>
+#include <fstream>
+#include <sstream>
 
 #include "../communication/communication_interface.h"
+#include "../communication/tcp_transport.h"
+#include "../communication/ucx_transport.h"
 #include "../unit/unit.h"
+#include "../statistics/statistics.h"
+#include "../counters/hardware_counters.h"
+#include "../counters/cpu_usage.h"
 
 struct ArgumentEntry
 {
@@ -37,7 +44,14 @@ enum CommunicationType
     COMM_FIXED_BLOCKING,
     COMM_FIXED_NONBLOCKING,
     COMM_VARIABLE_BLOCKING,
-    COMM_VARIABLE_NONBLOCKING
+    COMM_VARIABLE_NONBLOCKING,
+    COMM_TRACE_REPLAY,
+    COMM_FIXED_PACED,
+    COMM_INCAST,
+    COMM_FIXED_PIPELINED,
+    COMM_FIXED_FANOUT,
+    COMM_FIXED_STRIPED,
+    COMM_FIXED_PARTITIONED
 };
 
 class Benchmark : public CommunicationInterface
@@ -46,6 +60,11 @@ public:
     virtual ~Benchmark() {}
     virtual void run() = 0;
     virtual void performWarmup() = 0;
+    virtual void releaseResources() {} // MPI objects of the benchmark, before MPI_Finalize
+
+    void enableHardwareCounters();
+
+    Transport &transport() { return m_transport ? *m_transport : *this; }
 
     const std::string getPhasesFilepath() { return m_phasesFilepath; }
     void setPhasesFilepath(std::string path) { m_phasesFilepath = path; }
@@ -53,10 +72,63 @@ public:
     const std::string getAvgThroughputFilepath() { return m_avgThroughputFilepath; }
     void setAvgThroughputFilepath(std::string path) { m_avgThroughputFilepath = path; }
 
+    const std::string getLatencyFilepath() { return m_latencyFilepath; }
+    void setLatencyFilepath(std::string path) { m_latencyFilepath = path; }
+
+    const std::string getIncastFilepath() { return m_incastFilepath; }
+    void setIncastFilepath(std::string path) { m_incastFilepath = path; }
+
+    const std::string getPhaseSwitchFilepath() { return m_phaseSwitchFilepath; }
+    void setPhaseSwitchFilepath(std::string path) { m_phaseSwitchFilepath = path; }
+
+    const std::string getRailsFilepath() { return m_railsFilepath; }
+    void setRailsFilepath(std::string path) { m_railsFilepath = path; }
+
+    const std::string getOneWayFilepath() { return m_oneWayFilepath; }
+    void setOneWayFilepath(std::string path) { m_oneWayFilepath = path; }
+
+    const std::string getBarrierSkewFilepath() { return m_barrierSkewFilepath; }
+    void setBarrierSkewFilepath(std::string path) { m_barrierSkewFilepath = path; }
+
+    const std::string getCountersFilepath() { return m_countersFilepath; }
+    void setCountersFilepath(std::string path) { m_countersFilepath = path; }
+
+    const std::string getCpuUsageFilepath() { return m_cpuUsageFilepath; }
+    void setCpuUsageFilepath(std::string path) { m_cpuUsageFilepath = path; }
+
+    const std::string getPlacementFilepath() { return m_placementFilepath; }
+    void setPlacementFilepath(std::string path) { m_placementFilepath = path; }
+
+    const std::string getFaultInjectionFilepath() { return m_faultInjectionFilepath; }
+    void setFaultInjectionFilepath(std::string path) { m_faultInjectionFilepath = path; }
+
+    const std::string getRankTimingsFilepath() { return m_rankTimingsFilepath; }
+    void setRankTimingsFilepath(std::string path) { m_rankTimingsFilepath = path; }
+
+    const std::string getStragglersFilepath() { return m_stragglersFilepath; }
+    void setStragglersFilepath(std::string path) { m_stragglersFilepath = path; }
+
+    const std::string getLinkMatrixFilepath() { return m_linkMatrixFilepath; }
+    void setLinkMatrixFilepath(std::string path) { m_linkMatrixFilepath = path; }
+
+    const std::string getNodeLocalityFilepath() { return m_nodeLocalityFilepath; }
+    void setNodeLocalityFilepath(std::string path) { m_nodeLocalityFilepath = path; }
+
+    const std::string getTrialsFilepath() { return m_trialsFilepath; }
+    void setTrialsFilepath(std::string path) { m_trialsFilepath = path; }
+
 protected:
     timespec diff(timespec start, timespec end);
     std::vector<std::pair<int, int>> findSubarrayIndices(std::size_t bufferSize);
     std::pair<double, double> calculateThroughput(timespec startTime, timespec endTime, std::size_t bytesTransferred, std::size_t iterations);
+    void performTrialLogging(std::string commType, std::string messageSize, int phase, std::string ruId, std::string buId,
+                             const TrialStatistics &stats);
+    void performCounterLogging(std::string commType, std::string messageSize, int phase, std::string unitId, std::string peerId,
+                               std::size_t bytes, double seconds, const HardwareCounterValues &counters);
+    void performCpuUsageLogging(std::string commType, std::string messageSize, int phase, std::string unitId, std::string peerId,
+                                std::size_t bytes, std::size_t messages, double seconds, const CpuUsage &usage);
+
+    void initTransport();
 
     virtual void warmupCommunication(std::vector<std::pair<int, int>> subarrayIndices, int ruRank, int buRank) = 0;
     virtual void parseArguments(std::vector<ArgumentEntry> args) = 0;
@@ -69,10 +141,32 @@ protected:
 
     const std::size_t m_minIterations = 1e4;
 
+    std::size_t m_trials = 1; // repeated measurements per scan size / phase
+
+    HardwareCounters m_hardwareCounters; // sampled around every phase / scan size when open
+
+    std::string m_transportSpec = "mpi";    // -X, mpi | tcp | tcp-zerocopy | ucx | ucx-rma
+    std::unique_ptr<Transport> m_transport; // single-pair modes, this (MPI) when not set
+
     typedef std::unique_ptr<void, std::function<void(void *)>> buffer_t;
 
     std::string m_phasesFilepath;
     std::string m_avgThroughputFilepath;
+    std::string m_trialsFilepath;
+    std::string m_latencyFilepath;
+    std::string m_incastFilepath;
+    std::string m_phaseSwitchFilepath;
+    std::string m_railsFilepath;
+    std::string m_oneWayFilepath;
+    std::string m_barrierSkewFilepath;
+    std::string m_countersFilepath;
+    std::string m_cpuUsageFilepath;
+    std::string m_placementFilepath;
+    std::string m_faultInjectionFilepath;
+    std::string m_rankTimingsFilepath;
+    std::string m_stragglersFilepath;
+    std::string m_linkMatrixFilepath;
+    std::string m_nodeLocalityFilepath;
 };
 
 #endif // BENCHMARK_H
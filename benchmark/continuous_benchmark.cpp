@@ -30,6 +30,20 @@ std::string communicationTypeToString(CommunicationType commType)
         return "VARIABLE_BLOCKING";
     case COMM_VARIABLE_NONBLOCKING:
         return "VARIABLE_NONBLOCKING";
+    case COMM_TRACE_REPLAY:
+        return "TRACE_REPLAY";
+    case COMM_FIXED_PACED:
+        return "FIXED_PACED";
+    case COMM_INCAST:
+        return "INCAST";
+    case COMM_FIXED_PIPELINED:
+        return "FIXED_PIPELINED";
+    case COMM_FIXED_FANOUT:
+        return "FIXED_FANOUT";
+    case COMM_FIXED_STRIPED:
+        return "FIXED_STRIPED";
+    case COMM_FIXED_PARTITIONED:
+        return "FIXED_PARTITIONED";
     default:
         return "UNKNOWN";
     }
@@ -37,13 +51,20 @@ std::string communicationTypeToString(CommunicationType commType)
 
 std::string messageSizeToString(CommunicationType commType, std::size_t messageSize)
 {
-    if (commType == COMM_VARIABLE_BLOCKING || commType == COMM_VARIABLE_NONBLOCKING)
+    if (commType == COMM_VARIABLE_BLOCKING || commType == COMM_VARIABLE_NONBLOCKING || commType == COMM_TRACE_REPLAY)
     {
         return "VARIABLE";
     }
     return std::to_string(messageSize);
 }
 
+bool isFixedSize(CommunicationType commType)
+{
+    return commType == COMM_FIXED_BLOCKING || commType == COMM_FIXED_NONBLOCKING || commType == COMM_FIXED_PACED ||
+           commType == COMM_FIXED_PIPELINED || commType == COMM_FIXED_FANOUT ||
+           commType == COMM_FIXED_STRIPED || commType == COMM_FIXED_PARTITIONED;
+}
+
 void ContinuousBenchmark::initUnitLists()
 {
     UnitInfo tmpInfo;
@@ -88,6 +109,8 @@ void ContinuousBenchmark::initUnitLists()
         }
     }
 
+    m_linkMatrix.resize(m_readoutUnits.size(), m_builderUnits.size());
+
     if (m_rank == 0)
     {
         std::cout << "\nRUs:" << std::endl;
@@ -104,6 +127,312 @@ void ContinuousBenchmark::initUnitLists()
     }
 }
 
+/**
+ * @brief Open trace recording and/or replay files of this RU
+ *
+ * Must run after initUnitLists(). Paths resolve through tracePathForUnit() on both
+ * sides, so a recording is replayed with the same -T argument it was made with. The
+ * recorder is only attached at the end of performWarmup().
+ */
+void ContinuousBenchmark::initTrafficTrace()
+{
+    if (m_unit->getUnitType() != UnitType::RU)
+        return;
+
+    uint32_t ruIndex = std::stoul(m_unit->getId());
+
+    if (!m_traceRecordPath.empty())
+    {
+        std::string path = tracePathForUnit(m_traceRecordPath, m_unit->getId(), m_readoutUnits.size());
+        m_traceRecorder = std::make_unique<TraceWriter>(path, ruIndex, m_readoutUnits.size());
+    }
+
+    if (!m_traceReplayPath.empty())
+    {
+        m_traceReplay = std::make_unique<TraceReader>(tracePathForUnit(m_traceReplayPath, m_unit->getId(), m_readoutUnits.size()), ruIndex);
+        if (!m_traceReplay->isOpen())
+            MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
+/**
+ * @brief Free the communicators and the shared-memory window (collective)
+ */
+void ContinuousBenchmark::releaseResources()
+{
+    for (MPI_Comm &rail : m_railComms)
+        MPI_Comm_free(&rail);
+    m_railComms.clear();
+
+    for (MPI_Comm &comm : m_phaseComms)
+    {
+        if (comm != MPI_COMM_NULL)
+            MPI_Comm_free(&comm);
+    }
+    m_phaseComms.clear();
+
+    if (m_sharedWindow != MPI_WIN_NULL)
+    {
+        MPI_Win_unlock_all(m_sharedWindow);
+        MPI_Win_free(&m_sharedWindow);
+    }
+
+    if (m_nodeComm != MPI_COMM_NULL)
+        MPI_Comm_free(&m_nodeComm);
+}
+
+/**
+ * @brief Pin this rank next to its network device
+ *
+ * Must run after initUnitLists() and before the unit buffer is allocated. The thread is
+ * pinned to the device's local CPUs and the buffer bound to its NUMA node; whatever sysfs
+ * does not report is left unbound, see performPlacementLogging().
+ */
+void ContinuousBenchmark::initNicPlacement()
+{
+    if (!m_nicPinning)
+        return;
+
+    std::string device = m_unit->getNetworkDevice();
+    if (device.empty())
+    {
+        std::cerr << "Rank " << m_rank << ": no ibdev configured, NIC pinning skipped" << std::endl;
+        return;
+    }
+
+    m_nicLocality = readNicLocality(device);
+    m_cpuBound = pinThreadToCpus(parseCpuList(m_nicLocality.cpuList));
+    m_unit->setNumaNode(m_nicLocality.numaNode);
+}
+
+/**
+ * @brief Find the ranks sharing a node and, in shared-memory mode, map the BU segments
+ *
+ * Must run after initUnitLists(). Nodes are identified by their lowest world rank.
+ * With shared memory, every RU allocates its fragment buffer as its segment of a window
+ * over the node, kept locked for the whole run; BUs look up the segments of the node's RUs.
+ */
+void ContinuousBenchmark::initNodeLocality()
+{
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, m_rank, MPI_INFO_NULL, &m_nodeComm);
+
+    int node = m_rank;
+    MPI_Bcast(&node, 1, MPI_INT, 0, m_nodeComm);
+
+    m_nodeOfRank.resize(m_nodesCount);
+    MPI_Allgather(&node, 1, MPI_INT, m_nodeOfRank.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    m_colocatedPairs = 0;
+    for (const auto &ru : m_readoutUnits)
+    {
+        for (const auto &bu : m_builderUnits)
+            m_colocatedPairs += isIntraNode(ru.rank, bu.rank);
+    }
+
+    if (!m_sharedMemory)
+        return;
+
+    int8_t *segment = nullptr;
+    MPI_Aint segmentBytes = (m_unit->getUnitType() == UnitType::RU) ? m_ruBufferBytes : 0;
+    MPI_Win_allocate_shared(segmentBytes, 1, MPI_INFO_NULL, m_nodeComm, &segment, &m_sharedWindow);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, m_sharedWindow);
+
+    std::vector<int> nodeRanks;
+    for (int rank = 0; rank < m_nodesCount; rank++)
+    {
+        if (isIntraNode(rank, m_rank))
+            nodeRanks.push_back(rank);
+    }
+
+    // ranks of the node communicator follow the world ranks (key m_rank)
+    m_sharedSegments.assign(m_nodesCount, nullptr);
+    for (std::size_t nodeRank = 0; nodeRank < nodeRanks.size(); nodeRank++)
+    {
+        MPI_Aint size;
+        int displacementUnit;
+        int8_t *base = nullptr;
+        MPI_Win_shared_query(m_sharedWindow, nodeRank, &size, &displacementUnit, &base);
+        if (size > 0)
+            m_sharedSegments[nodeRanks[nodeRank]] = base;
+    }
+}
+
+/**
+ * @brief Create the communicators of the per-phase or per-pair scope
+ *
+ * Must run after initUnitLists(). The pairs of one phase are disjoint, so a single
+ * MPI_Comm_split per phase gives every pair its own communicator.
+ */
+void ContinuousBenchmark::initCommunicators()
+{
+    if (m_communicatorScope == SCOPE_WORLD)
+        return;
+
+    const int phases = m_nodesCount / 2;
+    const bool isRu = m_unit->getUnitType() == UnitType::RU;
+
+    m_phaseComms.assign(phases, MPI_COMM_NULL);
+
+    for (int phase = 0; phase < phases; phase++)
+    {
+        if (m_communicatorScope == SCOPE_PHASE)
+        {
+            MPI_Comm_dup(MPI_COMM_WORLD, &m_phaseComms[phase]);
+            continue;
+        }
+
+        // pairs are identified by their RU index
+        int pair = m_unit->getPair(phase);
+        int color = MPI_UNDEFINED;
+        if (pair != -1)
+            color = isRu ? std::stoi(m_unit->getId()) : pair;
+
+        MPI_Comm_split(MPI_COMM_WORLD, color, isRu ? 0 : 1, &m_phaseComms[phase]);
+    }
+}
+
+/**
+ * @brief Build the schedule selected with -L and apply it to the unit
+ *
+ * Must run after initUnitLists() and before initCommunicators(). Random schedules draw
+ * their seed on rank 0 so that all ranks shuffle alike.
+ */
+void ContinuousBenchmark::initSchedule()
+{
+    unsigned seed = std::random_device{}();
+    MPI_Bcast(&seed, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+
+    m_schedule = createScheduleGenerator(m_scheduleSpec, m_nodesCount / 2, seed);
+    if (!m_schedule)
+    {
+        if (m_rank == 0)
+            std::cerr << "Invalid schedule: " << m_scheduleSpec << " (linear, random[:seed], radix:<units per leaf> or file:<path> "
+                      << "with " << m_nodesCount / 2 << " phases of " << m_nodesCount / 2 << " units). Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (m_schedule->changesPerRound() && (m_communicatorScope == SCOPE_PAIR || m_commType == COMM_FIXED_PIPELINED))
+    {
+        if (m_rank == 0)
+            std::cerr << "Schedules changing every round cannot be used with per-pair communicators or pipelined mode. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    m_unit->applySchedule(*m_schedule);
+}
+
+void ContinuousBenchmark::parseCommunicatorScope(const std::string &scope)
+{
+    if (scope == "world")
+        m_communicatorScope = SCOPE_WORLD;
+    else if (scope == "phase")
+        m_communicatorScope = SCOPE_PHASE;
+    else if (scope == "pair")
+        m_communicatorScope = SCOPE_PAIR;
+    else
+    {
+        if (m_rank == 0)
+            std::cerr << "Invalid communicator scope: " << scope << " (world, phase or pair). Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+}
+
+void ContinuousBenchmark::addFaultSpec(const std::string &spec)
+{
+    FaultSpec fault;
+    if (!parseFaultSpec(spec, fault))
+    {
+        if (m_rank == 0)
+            std::cerr << "Invalid fault specification: " << spec << ". Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    m_faultInjector.add(fault);
+}
+
+std::string ContinuousBenchmark::describeMatching()
+{
+    std::string description = (m_communicatorScope == SCOPE_PAIR)    ? "communicator per pair"
+                              : (m_communicatorScope == SCOPE_PHASE) ? "communicator per phase"
+                                                                     : "MPI_COMM_WORLD";
+    if (m_anySource)
+        description += ", MPI_ANY_SOURCE receives";
+    return description;
+}
+
+MPI_Comm ContinuousBenchmark::phaseCommunicator(int phase)
+{
+    return m_phaseComms.empty() ? MPI_COMM_WORLD : m_phaseComms[phase];
+}
+
+/**
+ * @brief Translate a world rank of an RU or BU into the rank it has in phaseCommunicator()
+ */
+int ContinuousBenchmark::communicatorRank(int rank, UnitType type)
+{
+    if (m_communicatorScope != SCOPE_PAIR || rank == -1)
+        return rank;
+    return (type == UnitType::RU) ? 0 : 1;
+}
+
+/**
+ * @brief Rank of this unit's counterpart in a phase, -1 for dummies
+ */
+int ContinuousBenchmark::pairRank(int phase)
+{
+    int pair = m_unit->getPair(phase);
+    if (pair == -1)
+        return -1;
+
+    if (m_unit->getUnitType() == UnitType::RU)
+        return m_builderUnits.at(pair).rank;
+    return m_readoutUnits.at(pair).rank;
+}
+
+/**
+ * @brief BU side of the pipelined mode
+ *
+ * The unit buffer is split in two halves. Before waiting for the current batch, the receives
+ * of the following batch (the next phase's RU after the last batch of a phase) are posted
+ * into the other half, so they are already matched when that RU starts sending.
+ *
+ * @param phase
+ * @param batch Index of the communication call within the phase
+ * @return std::pair<std::size_t, std::size_t> Errors and transferred bytes of the current batch
+ */
+std::pair<std::size_t, std::size_t> ContinuousBenchmark::receivePipelined(int phase, std::size_t batch)
+{
+    const std::size_t halfBytes = m_unit->getBufferBytes() / 2;
+    const std::size_t batchesPerPhase = m_trials * m_messagesPerPhase;
+    const int phases = m_nodesCount / 2;
+
+    if (m_pipelinedRequests.empty())
+    {
+        m_pipelinedHalf = 0;
+        postReceives(m_unit.get(), communicatorRank(pairRank(phase), UnitType::RU), m_messageSize, m_iterations, 0, halfBytes,
+                     phaseCommunicator(phase), m_pipelinedRequests);
+    }
+
+    int nextPhase = (batch + 1 < batchesPerPhase) ? phase : (phase + 1) % phases;
+    int nextRuRank = pairRank(nextPhase);
+
+    std::vector<MPI_Request> nextRequests;
+    if (nextRuRank != -1)
+        postReceives(m_unit.get(), communicatorRank(nextRuRank, UnitType::RU), m_messageSize, m_iterations, (1 - m_pipelinedHalf) * halfBytes,
+                     halfBytes, phaseCommunicator(nextPhase), nextRequests);
+
+    std::pair<std::size_t, std::size_t> result = completeReceives(m_pipelinedRequests, m_messageSize);
+
+    m_pipelinedRequests = std::move(nextRequests);
+    m_pipelinedHalf = 1 - m_pipelinedHalf;
+
+    return result;
+}
+
 void ContinuousBenchmark::warmupCommunication(std::vector<std::pair<int, int>> subarrayIndices, int ruRank, int buRank)
 {
     std::size_t subarrayCount = subarrayIndices.size();
@@ -142,6 +471,12 @@ void ContinuousBenchmark::performWarmup()
     int ruRank, buRank;
     timespec startTime, endTime, elapsedTime;
 
+    if (m_nicPinning)
+    {
+        MPI_Barrier(MPI_COMM_WORLD); // log directories are created by rank 0
+        performPlacementLogging();
+    }
+
     double throughput;
     double currentRunTimeDiff = 0.0;
     std::pair<std::size_t, std::size_t> result = std::make_pair(0, 0);
@@ -152,6 +487,7 @@ void ContinuousBenchmark::performWarmup()
     std::vector<std::pair<int, int>> subarrayIndices = findSubarrayIndices(m_ruBufferBytes);
 
     // pre-warmup test
+    uint64_t stageStart = CycleTimer::now();
     clock_gettime(CLOCK_MONOTONIC, &startTime);
     for (int phase = 0; phase < m_nodesCount / 2; phase++)
     {
@@ -186,6 +522,7 @@ void ContinuousBenchmark::performWarmup()
         }
     }
     clock_gettime(CLOCK_MONOTONIC, &endTime);
+    Timeline::record("pre-warmup test", stageStart);
     std::tie(std::ignore, throughput) = calculateThroughput(startTime, endTime, transferredSize, m_warmupIterations * (m_nodesCount / 2));
 
     if (m_rank == buRank)
@@ -196,6 +533,7 @@ void ContinuousBenchmark::performWarmup()
     ////////////////////
 
     // perform warmup
+    stageStart = CycleTimer::now();
     for (int phase = 0; phase < m_nodesCount / 2; phase++)
     {
         MPI_Barrier(MPI_COMM_WORLD);
@@ -213,6 +551,7 @@ void ContinuousBenchmark::performWarmup()
 
         warmupCommunication(subarrayIndices, ruRank, buRank);
     }
+    Timeline::record("warmup", stageStart);
 
     if (m_rank == 0)
         std::cout << "Done.\n\n"
@@ -222,6 +561,7 @@ void ContinuousBenchmark::performWarmup()
 
     transferredSize = 0;
     currentRunTimeDiff = 0;
+    stageStart = CycleTimer::now();
     clock_gettime(CLOCK_MONOTONIC, &startTime);
 
     // post-warmup test
@@ -259,12 +599,17 @@ void ContinuousBenchmark::performWarmup()
         }
     }
     clock_gettime(CLOCK_MONOTONIC, &endTime);
+    Timeline::record("post-warmup test", stageStart);
 
     std::tie(std::ignore, throughput) = calculateThroughput(startTime, endTime, transferredSize, m_warmupIterations * (m_nodesCount / 2));
 
     if (m_rank == buRank)
         std::cout << "Avg. post-warmup throughput: " << throughput << " Mbit/s"
                   << std::endl;
+
+    // warmup traffic is not part of the recorded trace
+    if (m_traceRecorder && m_traceRecorder->isOpen())
+        setTraceWriter(m_traceRecorder.get());
 }
 
 void ContinuousBenchmark::performPhaseLogging(std::string ruId, std::string buId, std::string ruHost, std::string buHost, int phase,
@@ -276,7 +621,7 @@ void ContinuousBenchmark::performPhaseLogging(std::string ruId, std::string buId
               << " | " << std::setw(7) << "RU"
               << " | " << std::setw(7) << "BU";
 
-    if (m_commType == COMM_FIXED_BLOCKING || m_commType == COMM_FIXED_NONBLOCKING)
+    if (isFixedSize(m_commType))
         std::cout << " | " << std::setw(14) << " Avg. RTT";
 
     std::cout << " | " << std::setw(25) << "Throughput"
@@ -288,7 +633,7 @@ void ContinuousBenchmark::performPhaseLogging(std::string ruId, std::string buId
               << " | " << std::setw(7) << ruId
               << " | " << std::setw(7) << buId;
 
-    if (m_commType == COMM_FIXED_BLOCKING || m_commType == COMM_FIXED_NONBLOCKING)
+    if (isFixedSize(m_commType))
         std::cout << " | " << std::setw(12) << averageRtt << " s";
 
     std::cout << " | " << std::setw(18) << std::fixed << std::setprecision(2) << throughput << " Mbit/s"
@@ -317,7 +662,7 @@ void ContinuousBenchmark::performPhaseLogging(std::string ruId, std::string buId
                    << buId << ","
                    << ruHost << ","
                    << buHost << ",";
-        if (m_commType == COMM_FIXED_BLOCKING || m_commType == COMM_FIXED_NONBLOCKING)
+        if (isFixedSize(m_commType))
             outputFile << std::fixed << std::setprecision(8) << averageRtt;
         outputFile << "," << std::fixed << std::setprecision(1) << throughput
                    << "," << std::fixed << std::setprecision(1) << throughputBarrier << ","
@@ -334,10 +679,15 @@ void ContinuousBenchmark::performPhaseLogging(std::string ruId, std::string buId
 void ContinuousBenchmark::performPeriodicalLogging()
 {
     double avgThroughput = (m_totalTransferredSize * 8.0) / (m_totalElapsedTime * 1e6);
+    double cpuNsPerByte = (m_totalTransferredSize > 0) ? m_totalCpuTime * 1e9 / m_totalTransferredSize : 0.0;
 
     std::cout << std::fixed << std::setprecision(2);
 
-    std::cout << "Average throughput in " << m_lastAvgCalculationInterval << "s: " << avgThroughput << " Mbit/s" << std::endl
+    std::cout << "Average throughput in " << m_lastAvgCalculationInterval << "s: " << avgThroughput << " Mbit/s"
+              << std::setprecision(3) << " | BU CPU " << cpuNsPerByte << " ns/B";
+    if (m_totalCopiedSends > 0)
+        std::cout << " | " << m_totalCopiedSends << " zero-copy sends copied by the kernel";
+    std::cout << std::endl
               << std::endl;
 
     std::ofstream outputFile(m_avgThroughputFilepath, std::ios::app);
@@ -346,7 +696,7 @@ void ContinuousBenchmark::performPeriodicalLogging()
         outputFile.seekp(0, std::ios::end);
         if (outputFile.tellp() == 0)
         {
-            outputFile << "timestamp,comm_type,message_size,throughput\n"; // File is empty, add the header
+            outputFile << "timestamp,comm_type,message_size,throughput,bu_cpu_ns_per_byte,copied_sends\n"; // File is empty, add the header
         }
 
         std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
@@ -354,7 +704,9 @@ void ContinuousBenchmark::performPeriodicalLogging()
         outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
                    << communicationTypeToString(m_commType) << ","
                    << messageSizeToString(m_commType, m_messageSize) << ","
-                   << avgThroughput << "\n";
+                   << avgThroughput << ","
+                   << std::fixed << std::setprecision(3) << cpuNsPerByte << ","
+                   << m_totalCopiedSends << "\n";
 
         outputFile.close();
     }
@@ -364,158 +716,1364 @@ void ContinuousBenchmark::performPeriodicalLogging()
     }
 }
 
-void ContinuousBenchmark::handleAverageThroughput(std::size_t transferredSize, double currentRunTimeDiff, timespec endTime)
+/**
+ * @brief Log the throughput every stripe channel achieved in a phase of the striped mode
+ *
+ * A channel is one rail communicator, the device its stripes take is the MPI transport's
+ * choice, so these are per-communicator and not per-HCA figures. Channel throughput is the
+ * channel's bytes over the time until its last stripe completed, so a channel that finishes
+ * early is not penalised for waiting on the other one.
+ */
+void ContinuousBenchmark::performRailLogging(std::string ruId, std::string buId, int phase, const std::vector<RailStatistics> &railStatistics)
 {
-    for (const auto &unit : m_builderUnits)
+    std::ofstream outputFile(m_railsFilepath, std::ios::app);
+    if (outputFile.is_open())
     {
-        int buRank = unit.rank;
-
-        std::size_t tmpTransferredSize = 0;
-        double tmpElapsedTime = 0.0;
-
-        if (m_rank == 0 && buRank == 0) // 0 is one of the BUs
-        {
-            m_totalTransferredSize += transferredSize;
-            m_totalElapsedTime += currentRunTimeDiff;
-        }
-        else if (m_rank == 0) // receive info from BUs
-        {
-            MPI_Recv(&tmpTransferredSize, 1, MPI_UNSIGNED_LONG_LONG, buRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            MPI_Recv(&tmpElapsedTime, 1, MPI_DOUBLE, buRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-            m_totalTransferredSize += tmpTransferredSize;
-            m_totalElapsedTime += tmpElapsedTime;
-        }
-        else if (m_rank == buRank) // send info from BUs to 0
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
         {
-            MPI_Send(&transferredSize, 1, MPI_UNSIGNED_LONG_LONG, 0, 0, MPI_COMM_WORLD);
-            MPI_Send(&currentRunTimeDiff, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+            outputFile << "timestamp,message_size,stripe_size,phase,ru,bu,channel,throughput,errors\n";
         }
     }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_railsFilepath << std::endl;
+    }
 
-    if (m_rank == 0)
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+    for (std::size_t rail = 0; rail < railStatistics.size(); rail++)
     {
-        timespec lastAvgCalculationDiff = diff(m_lastAvgCalculationTime, endTime);
-        double secsFromLastAvg = lastAvgCalculationDiff.tv_sec + (lastAvgCalculationDiff.tv_nsec / 1e9);
-        if (secsFromLastAvg >= m_lastAvgCalculationInterval) // interval exceeded, perform logging
+        const RailStatistics &stats = railStatistics[rail];
+        double throughput = (stats.elapsedTime > 0) ? (stats.transferredSize * 8.0) / (stats.elapsedTime * 1e6) : 0.0;
+
+        std::cout << std::fixed << std::setprecision(2) << (rail ? " | " : "")
+                  << "Channel " << rail << ": " << throughput << " Mbit/s";
+
+        if (outputFile.is_open())
         {
-            performPeriodicalLogging();
-            m_totalTransferredSize = 0;
-            m_totalElapsedTime = 0.0;
-            clock_gettime(CLOCK_MONOTONIC, &m_lastAvgCalculationTime);
-            return;
+            outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                       << m_messageSize << ","
+                       << m_stripeSize << ","
+                       << phase << ","
+                       << ruId << ","
+                       << buId << ","
+                       << rail << ","
+                       << std::fixed << std::setprecision(1) << throughput << ","
+                       << stats.errors << "\n";
         }
     }
+
+    std::cout << std::endl
+              << std::endl;
 }
 
-void ContinuousBenchmark::run()
+void ContinuousBenchmark::performPhaseSwitchLogging(std::string ruId, std::string buId, int phase, double gap)
 {
-    int ruRank, buRank;
-    std::string ruId, buId, ruHost, buHost;
-
-    timespec startTime, startTimeBarrier, endTime;
-
-    std::pair<std::size_t, std::size_t> result = std::make_pair(0, 0);
+    std::cout << std::fixed << std::setprecision(2) << "Phase-switch gap: " << gap * 1e6 << " us" << std::endl
+              << std::endl;
 
-    for (int phase = 0; phase < m_nodesCount / 2; phase++)
+    std::ofstream outputFile(m_phaseSwitchFilepath, std::ios::app);
+    if (outputFile.is_open())
     {
-        clock_gettime(CLOCK_MONOTONIC, &startTimeBarrier);
-        MPI_Barrier(MPI_COMM_WORLD);
-        if (m_rank == 0)
-            std::cout << "\n\n===========================================================================\n\n"
-                      << std::endl;
-
-        if (m_unit->getUnitType() == UnitType::RU)
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
         {
-            ruRank = m_rank;
-            ruId = m_unit->getId();
-            ruHost = m_unit->getHostname();
-
-            buRank = m_builderUnits.at(m_unit->getPair(phase)).rank;
-            buId = (buRank == -1) ? "-1" : m_builderUnits.at(m_unit->getPair(phase)).id;
-            buHost = (buRank == -1) ? "DUMMY" : m_unit->getPairHost(m_unit->getPair(phase));
+            outputFile << "timestamp,comm_type,message_size,message_count,phase,ru,bu,gap\n";
         }
-        else if (m_unit->getUnitType() == UnitType::BU)
-        {
-            buRank = m_rank;
-            buId = m_unit->getId();
-            buHost = m_unit->getHostname();
 
-            ruRank = m_readoutUnits.at(m_unit->getPair(phase)).rank;
-            ruId = (ruRank == -1) ? "-1" : m_readoutUnits.at(m_unit->getPair(phase)).id;
-            ruHost = (ruRank == -1) ? "DUMMY" : m_unit->getPairHost(m_unit->getPair(phase));
-        }
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 
-        // perform communication
-        timespec elapsedTime;
-        std::size_t errorMessageCount = 0;
-        std::size_t transferredSize = 0;
-        double currentRunTimeDiff = 0.0, currentRunTimeDiffBarrier = 0.0;
+        outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                   << communicationTypeToString(m_commType) << ","
+                   << messageSizeToString(m_commType, m_messageSize) << ","
+                   << m_messagesPerPhase << ","
+                   << phase << ","
+                   << ruId << ","
+                   << buId << ","
+                   << std::fixed << std::setprecision(8) << gap << "\n";
 
-        if (ruRank != -1 && buRank != -1) // skip communication involving dummy nodes
-        {
-            for (int message = 0; message < m_messagesPerPhase; message++)
-            {
-                clock_gettime(CLOCK_MONOTONIC, &startTime);
+        outputFile.close();
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_phaseSwitchFilepath << std::endl;
+    }
+}
 
-                if (m_commType == COMM_FIXED_BLOCKING)
-                    result = CommunicationInterface::blockingCommunication(m_unit.get(), ruRank, buRank, m_rank, m_messageSize, m_iterations);
+/**
+ * @brief Log one point of the latency-under-load curve
+ *
+ * @param ruId
+ * @param buId
+ * @param phase
+ * @param eventRate Offered fragment rate (Hz)
+ * @param throughput Achieved throughput (Mbit/s)
+ * @param latencies Per-fragment latencies relative to nominal emission time (s)
+ */
+void ContinuousBenchmark::performLatencyLogging(std::string ruId, std::string buId, int phase, double eventRate, double throughput,
+                                                const std::vector<double> &latencies)
+{
+    double offeredLoad = eventRate * m_messageSize * 8.0 / 1e6;
+    double p50 = percentile(latencies, 0.5);
+    double p99 = percentile(latencies, 0.99);
+    double p999 = percentile(latencies, 0.999);
+    double maxLatency = latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end());
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Offered " << offeredLoad << " Mbit/s | achieved " << throughput << " Mbit/s"
+              << std::setprecision(2) << " | latency p50 " << p50 * 1e6 << " us"
+              << " | p99 " << p99 * 1e6 << " us"
+              << " | p99.9 " << p999 * 1e6 << " us"
+              << " | max " << maxLatency * 1e6 << " us" << std::endl
+              << std::endl;
 
-                else if (m_commType == COMM_FIXED_NONBLOCKING)
-                    result = CommunicationInterface::nonBlockingCommunication(m_unit.get(), ruRank, buRank, m_rank, m_messageSize, m_iterations);
+    std::ofstream outputFile(m_latencyFilepath, std::ios::app);
+    if (outputFile.is_open())
+    {
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
+        {
+            outputFile << "timestamp,message_size,phase,ru,bu,event_rate,offered_load,throughput,latency_p50,latency_p99,latency_p999,latency_max\n";
+        }
 
-                else if (m_commType == COMM_VARIABLE_BLOCKING)
-                    result = CommunicationInterface::variableBlockingCommunication(m_unit.get(), ruRank, buRank, m_rank, m_messageSizes, m_iterations);
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 
-                else if (m_commType == COMM_VARIABLE_NONBLOCKING)
-                    result = CommunicationInterface::variableNonBlockingCommunication(m_unit.get(), ruRank, buRank, m_rank, m_messageSizes, m_iterations);
+        outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                   << m_messageSize << ","
+                   << phase << ","
+                   << ruId << ","
+                   << buId << ","
+                   << std::fixed << std::setprecision(1) << eventRate << ","
+                   << offeredLoad << ","
+                   << throughput << ","
+                   << std::setprecision(8) << p50 << ","
+                   << p99 << ","
+                   << p999 << ","
+                   << maxLatency << "\n";
 
-                // perform logging and reset result variable
-                if (m_rank == buRank)
-                {
-                    errorMessageCount += result.first;
-                    transferredSize += result.second;
+        outputFile.close();
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_latencyFilepath << std::endl;
+    }
+}
 
-                    result = std::make_pair(0, 0);
-                }
-                else if (m_rank == ruRank)
-                {
-                    result = std::make_pair(0, 0);
-                }
+/**
+ * @brief Print and log the placement chosen by initNicPlacement()
+ */
+void ContinuousBenchmark::performPlacementLogging()
+{
+    std::cout << "Rank " << m_rank << " placement: " << (m_nicLocality.device.empty() ? "no device" : m_nicLocality.device)
+              << ", NUMA node " << m_nicLocality.numaNode << (m_unit->isMemoryBound() ? " (buffer bound)" : " (buffer unbound)")
+              << ", CPUs " << (m_nicLocality.cpuList.empty() ? "-" : m_nicLocality.cpuList) << (m_cpuBound ? " (pinned)" : " (unpinned)")
+              << std::endl;
 
-                clock_gettime(CLOCK_MONOTONIC, &endTime);
+    std::ofstream outputFile(m_placementFilepath, std::ios::app);
+    if (outputFile.is_open())
+    {
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
+        {
+            outputFile << "timestamp,rank,unit,host,device,numa_node,memory_bound,cpus,cpu_bound\n";
+        }
 
-                elapsedTime = diff(startTime, endTime);
-                currentRunTimeDiff += (elapsedTime.tv_sec + (elapsedTime.tv_nsec / 1e9));
-            }
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 
-            clock_gettime(CLOCK_MONOTONIC, &endTime);
+        outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                   << m_rank << ","
+                   << m_unit->getId() << ","
+                   << m_unit->getHostname() << ","
+                   << m_nicLocality.device << ","
+                   << m_nicLocality.numaNode << ","
+                   << m_unit->isMemoryBound() << ","
+                   << "\"" << m_nicLocality.cpuList << "\","
+                   << m_cpuBound << "\n";
 
-            elapsedTime = diff(startTimeBarrier, endTime);
-            currentRunTimeDiffBarrier = (elapsedTime.tv_sec + (elapsedTime.tv_nsec / 1e9));
-        }
+        outputFile.close();
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_placementFilepath << std::endl;
+    }
+}
 
-        if ((m_rank == buRank) || (buRank == -1))
+/**
+ * @brief Log the distribution of one phase's one-way RU to BU fragment latencies
+ *
+ * Latencies are arrival minus send time in rank 0's timebase, their error is bounded
+ * by half the sum of both ranks' synchronisation round trips.
+ *
+ * @param ruId
+ * @param buId
+ * @param phase
+ * @param latencies Per-fragment one-way latencies (s)
+ */
+void ContinuousBenchmark::performOneWayLatencyLogging(std::string ruId, std::string buId, int phase, const std::vector<double> &latencies)
+{
+    double minLatency = *std::min_element(latencies.begin(), latencies.end());
+    double maxLatency = *std::max_element(latencies.begin(), latencies.end());
+    double p50 = percentile(latencies, 0.5);
+    double p99 = percentile(latencies, 0.99);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "One-way latency min " << minLatency * 1e6 << " us"
+              << " | p50 " << p50 * 1e6 << " us"
+              << " | p99 " << p99 * 1e6 << " us"
+              << " | max " << maxLatency * 1e6 << " us" << std::endl
+              << std::endl;
+
+    std::ofstream outputFile(m_oneWayFilepath, std::ios::app);
+    if (outputFile.is_open())
+    {
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
+        {
+            outputFile << "timestamp,comm_type,message_size,phase,ru,bu,fragments,latency_min,latency_p50,latency_p99,latency_max,bu_sync_rtt\n";
+        }
+
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+        outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                   << communicationTypeToString(m_commType) << ","
+                   << m_messageSize << ","
+                   << phase << ","
+                   << ruId << ","
+                   << buId << ","
+                   << latencies.size() << ","
+                   << std::fixed << std::setprecision(8) << minLatency << ","
+                   << p50 << ","
+                   << p99 << ","
+                   << maxLatency << ","
+                   << ClockSync::getRoundTrip() << "\n";
+
+        outputFile.close();
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_oneWayFilepath << std::endl;
+    }
+}
+
+/**
+ * @brief Gather this round's barrier arrival times on rank 0 and log their spread per phase (collective)
+ *
+ * The skew is the time between the first and the last rank entering a phase barrier,
+ * the last rank is the one every other rank waited for.
+ */
+void ContinuousBenchmark::performBarrierSkewLogging()
+{
+    if (!ClockSync::isEnabled())
+        return;
+
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    const std::size_t phases = m_barrierArrivals.size();
+    std::vector<double> arrivals(m_rank == 0 ? phases * size : 0);
+    MPI_Gather(m_barrierArrivals.data(), phases, MPI_DOUBLE, arrivals.data(), phases, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    if (m_rank != 0)
+        return;
+
+    std::ofstream outputFile(m_barrierSkewFilepath, std::ios::app);
+    if (!outputFile.is_open())
+    {
+        std::cerr << "Failed to open file: " << m_barrierSkewFilepath << std::endl;
+        return;
+    }
+
+    outputFile.seekp(0, std::ios::end);
+    if (outputFile.tellp() == 0)
+    {
+        outputFile << "timestamp,comm_type,message_size,phase,skew,last_rank\n";
+    }
+
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+    double maxSkew = 0.0;
+    for (std::size_t phase = 0; phase < phases; phase++)
+    {
+        int first = 0, last = 0;
+        for (int rank = 1; rank < size; rank++)
+        {
+            if (arrivals[rank * phases + phase] < arrivals[first * phases + phase])
+                first = rank;
+            if (arrivals[rank * phases + phase] > arrivals[last * phases + phase])
+                last = rank;
+        }
+
+        double skew = arrivals[last * phases + phase] - arrivals[first * phases + phase];
+        maxSkew = std::max(maxSkew, skew);
+
+        outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                   << communicationTypeToString(m_commType) << ","
+                   << messageSizeToString(m_commType, m_messageSize) << ","
+                   << phase << ","
+                   << std::fixed << std::setprecision(8) << skew << ","
+                   << last << "\n";
+    }
+
+    outputFile.close();
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Barrier arrival skew: max " << maxSkew * 1e6 << " us over " << phases << " phases" << std::endl;
+}
+
+/**
+ * @brief Cluster-wide throughput of the round, against the last baseline round if faults were injected (collective)
+ *
+ * @param roundTransferredSize Bytes this rank received in the round (BU)
+ * @param roundStart Start of the round on this rank (CycleTimer ticks)
+ */
+void ContinuousBenchmark::performFaultInjectionLogging(std::size_t roundTransferredSize, uint64_t roundStart)
+{
+    unsigned long long localSize = roundTransferredSize, totalSize = 0;
+    MPI_Reduce(&localSize, &totalSize, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (m_rank != 0)
+        return;
+
+    double throughput = (totalSize * 8.0) / (CycleTimer::toSeconds(CycleTimer::now() - roundStart) * 1e6);
+    bool injected = m_faultInjector.isActive();
+    double cost = (injected && m_baselineThroughput > 0) ? 1.0 - throughput / m_baselineThroughput : 0.0;
+
+    if (!injected)
+        m_baselineThroughput = throughput;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Fault injection: " << (injected ? "injected" : "baseline") << " round " << m_round
+              << " | cluster " << throughput << " Mbit/s";
+    if (injected && m_baselineThroughput > 0)
+        std::cout << " | baseline " << m_baselineThroughput << " Mbit/s | cost " << cost * 100 << "%";
+    std::cout << std::endl;
+
+    std::ofstream outputFile(m_faultInjectionFilepath, std::ios::app);
+    if (!outputFile.is_open())
+    {
+        std::cerr << "Failed to open file: " << m_faultInjectionFilepath << std::endl;
+        return;
+    }
+
+    outputFile.seekp(0, std::ios::end);
+    if (outputFile.tellp() == 0)
+    {
+        outputFile << "timestamp,comm_type,message_size,round,injected,throughput,baseline_throughput,throughput_cost,faults\n";
+    }
+
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+               << communicationTypeToString(m_commType) << ","
+               << messageSizeToString(m_commType, m_messageSize) << ","
+               << m_round << ","
+               << injected << ","
+               << std::fixed << std::setprecision(2) << throughput << ","
+               << m_baselineThroughput << ",";
+    if (injected && m_baselineThroughput > 0)
+        outputFile << std::setprecision(4) << cost;
+    outputFile << "," << (injected ? m_faultInjector.describe() : "") << "\n";
+
+    outputFile.close();
+}
+
+/**
+ * @brief Log every rank's timings of an analysed round and the ranked suspects so far (rank 0)
+ *
+ * @param round Round the timings belong to
+ */
+void ContinuousBenchmark::performStragglerLogging(std::size_t round)
+{
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+    std::ofstream timingsFile(m_rankTimingsFilepath, std::ios::app);
+    if (!timingsFile.is_open())
+    {
+        std::cerr << "Failed to open file: " << m_rankTimingsFilepath << std::endl;
+        return;
+    }
+
+    timingsFile.seekp(0, std::ios::end);
+    if (timingsFile.tellp() == 0)
+    {
+        timingsFile << "timestamp,comm_type,message_size,round,phase,rank,host,device,role,peer,start,end,"
+                    << "barrier_wait,busy_time,bytes,time_score,wait_score\n";
+    }
+
+    for (const RankTiming &rankTiming : m_stragglerDetector.getRoundTimings())
+    {
+        const PhaseTiming &timing = rankTiming.timing;
+        timingsFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                    << communicationTypeToString(m_commType) << ","
+                    << messageSizeToString(m_commType, m_messageSize) << ","
+                    << round << ","
+                    << static_cast<int>(timing.phase) << ","
+                    << rankTiming.rank << ","
+                    << m_stragglerDetector.getHost(rankTiming.rank) << ","
+                    << m_stragglerDetector.getDevice(rankTiming.rank) << ","
+                    << (timing.role == 0 ? "RU" : timing.role == 1 ? "BU" : "IDLE") << ","
+                    << static_cast<int>(timing.peer) << ","
+                    << std::fixed << std::setprecision(6) << timing.start << ","
+                    << timing.end << ","
+                    << std::setprecision(8) << timing.barrierWait << ","
+                    << timing.busyTime << ","
+                    << static_cast<std::size_t>(timing.bytes) << ","
+                    << std::setprecision(2) << rankTiming.timeScore << ","
+                    << rankTiming.waitScore << "\n";
+    }
+
+    timingsFile.close();
+
+    std::vector<StragglerSuspect> hosts = m_stragglerDetector.hostSuspects();
+    std::vector<StragglerSuspect> links = m_stragglerDetector.linkSuspects();
+    if (hosts.empty() && links.empty())
+        return;
+
+    std::ofstream suspectsFile(m_stragglersFilepath, std::ios::app);
+    if (!suspectsFile.is_open())
+    {
+        std::cerr << "Failed to open file: " << m_stragglersFilepath << std::endl;
+        return;
+    }
+
+    suspectsFile.seekp(0, std::ios::end);
+    if (suspectsFile.tellp() == 0)
+    {
+        suspectsFile << "timestamp,comm_type,message_size,round,position,kind,rank,host,device,peer_rank,peer_host,peer_device,"
+                     << "flagged,observed,ratio,max_score\n";
+    }
+
+    std::cout << "\nSuspected stragglers after round " << round << " (flagged / observed phases or rounds, max modified z-score):" << std::endl;
+
+    std::size_t position = 0;
+    for (const std::vector<StragglerSuspect> *suspects : {&hosts, &links})
+    {
+        for (const StragglerSuspect &suspect : *suspects)
+        {
+            bool isLink = suspect.peer >= 0;
+            std::string name = m_stragglerDetector.getHost(suspect.rank) + " " + m_stragglerDetector.getDevice(suspect.rank);
+            if (isLink)
+                name += " -> " + m_stragglerDetector.getHost(suspect.peer) + " " + m_stragglerDetector.getDevice(suspect.peer);
+
+            position++;
+            std::cout << std::fixed << std::setprecision(2)
+                      << "  " << position << ". " << (isLink ? "link " : "host ") << name
+                      << " (rank " << suspect.rank << (isLink ? " -> " + std::to_string(suspect.peer) : "") << "): "
+                      << suspect.flagged << " / " << suspect.observed << ", " << suspect.maxScore << std::endl;
+
+            suspectsFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                         << communicationTypeToString(m_commType) << ","
+                         << messageSizeToString(m_commType, m_messageSize) << ","
+                         << round << ","
+                         << position << ","
+                         << (isLink ? "link" : "host") << ","
+                         << suspect.rank << ","
+                         << m_stragglerDetector.getHost(suspect.rank) << ","
+                         << m_stragglerDetector.getDevice(suspect.rank) << ",";
+            if (isLink)
+                suspectsFile << suspect.peer << ","
+                             << m_stragglerDetector.getHost(suspect.peer) << ","
+                             << m_stragglerDetector.getDevice(suspect.peer) << ",";
+            else
+                suspectsFile << ",,,";
+            suspectsFile << suspect.flagged << ","
+                         << suspect.observed << ","
+                         << std::fixed << std::setprecision(4) << suspect.ratio() << ","
+                         << std::setprecision(2) << suspect.maxScore << "\n";
+        }
+    }
+
+    suspectsFile.close();
+}
+
+/**
+ * @brief Fold this phase of every BU's pair into rank 0's link matrix
+ *
+ * @param ruIndex RU the calling BU received from, -1 on RUs and for dummy pairs
+ * @param transferredSize Bytes received in the phase
+ * @param currentRunTimeDiff Time spent in communication in the phase
+ * @param errors Erroneous fragments in the phase
+ */
+void ContinuousBenchmark::handleLinkMatrix(int ruIndex, std::size_t transferredSize, double currentRunTimeDiff, std::size_t errors)
+{
+    double sample[6] = {-1.0, 0.0, 0.0, 0.0, 0.0, 0.0}; // RU index, throughput, RTT, errors, bytes, time
+    if (ruIndex >= 0 && currentRunTimeDiff > 0)
+    {
+        sample[0] = ruIndex;
+        sample[1] = (transferredSize * 8.0) / (currentRunTimeDiff * 1e6);
+        sample[2] = currentRunTimeDiff / (m_iterations * m_messagesPerPhase * m_trials);
+        sample[3] = errors;
+        sample[4] = transferredSize;
+        sample[5] = currentRunTimeDiff;
+    }
+
+    for (std::size_t bu = 0; bu < m_builderUnits.size(); bu++)
+    {
+        int buRank = m_builderUnits[bu].rank;
+
+        if (m_rank == 0 && buRank != 0)
+        {
+            MPI_Recv(sample, 6, MPI_DOUBLE, buRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+        else if (m_rank == buRank && m_rank != 0)
+        {
+            MPI_Send(sample, 6, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+            return;
+        }
+
+        if (m_rank == 0 && sample[0] >= 0)
+        {
+            std::size_t ru = static_cast<std::size_t>(sample[0]);
+            m_linkMatrix.update(ru, bu, sample[1], sample[2], static_cast<std::size_t>(sample[3]));
+
+            int locality = isIntraNode(m_readoutUnits[ru].rank, buRank) ? 1 : 0;
+            m_localityTransferredSize[locality] += static_cast<std::size_t>(sample[4]);
+            m_localityElapsedTime[locality] += sample[5];
+        }
+    }
+}
+
+void ContinuousBenchmark::performLinkMatrixLogging()
+{
+    if (m_linkMatrix.empty())
+        return;
+
+    std::vector<std::string> ruIds, buIds;
+    for (const auto &unit : m_readoutUnits)
+        ruIds.push_back(unit.id);
+    for (const auto &unit : m_builderUnits)
+        buIds.push_back(unit.id);
+
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::ostringstream description;
+    description << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ", "
+                << communicationTypeToString(m_commType) << ", "
+                << messageSizeToString(m_commType, m_messageSize)
+                << ", throughput in Mbit/s and rtt in s per fragment are means over the phases of each pair";
+
+    if (!m_linkMatrix.write(m_linkMatrixFilepath, description.str(), ruIds, buIds))
+        std::cerr << "Failed to open file: " << m_linkMatrixFilepath << std::endl;
+}
+
+/**
+ * @brief Average throughput of intra-node and inter-node pairs over the logging interval (rank 0)
+ *
+ * Only printed when some pair shares a node, so fabric numbers can be read without them.
+ */
+void ContinuousBenchmark::performNodeLocalityLogging()
+{
+    std::size_t totalTransferredSize = m_localityTransferredSize[0] + m_localityTransferredSize[1];
+    if (totalTransferredSize == 0)
+        return;
+
+    const char *localities[] = {"inter_node", "intra_node"};
+    double throughputs[2];
+    for (int locality = 0; locality < 2; locality++)
+    {
+        throughputs[locality] = (m_localityElapsedTime[locality] > 0)
+                                    ? (m_localityTransferredSize[locality] * 8.0) / (m_localityElapsedTime[locality] * 1e6)
+                                    : 0.0;
+    }
+
+    if (m_localityTransferredSize[1] > 0)
+    {
+        std::cout << std::fixed << std::setprecision(2);
+        if (m_localityTransferredSize[0] > 0)
+            std::cout << "Inter-node pairs: " << throughputs[0] << " Mbit/s | ";
+        std::cout << "Intra-node pairs" << (m_sharedMemory ? " (shared memory): " : ": ") << throughputs[1] << " Mbit/s" << std::endl
+                  << std::endl;
+    }
+
+    std::ofstream outputFile(m_nodeLocalityFilepath, std::ios::app);
+    if (outputFile.is_open())
+    {
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
+        {
+            outputFile << "timestamp,comm_type,message_size,locality,shared_memory,throughput,bytes_share\n";
+        }
+
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+        for (int locality = 0; locality < 2; locality++)
+        {
+            if (m_localityTransferredSize[locality] == 0)
+                continue;
+
+            outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                       << communicationTypeToString(m_commType) << ","
+                       << messageSizeToString(m_commType, m_messageSize) << ","
+                       << localities[locality] << ","
+                       << (locality == 1 && m_sharedMemory) << ","
+                       << std::fixed << std::setprecision(2) << throughputs[locality] << ","
+                       << std::setprecision(4) << double(m_localityTransferredSize[locality]) / totalTransferredSize << "\n";
+        }
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_nodeLocalityFilepath << std::endl;
+    }
+
+    for (int locality = 0; locality < 2; locality++)
+    {
+        m_localityTransferredSize[locality] = 0;
+        m_localityElapsedTime[locality] = 0.0;
+    }
+}
+
+void ContinuousBenchmark::setScheduleOptimizer(const std::string &spec)
+{
+    if (!parseOptimizerSpec(spec, m_optimizedConfigPath, m_optimizerObjective, m_optimizerRadix))
+    {
+        if (m_rank == 0)
+            std::cerr << "Invalid schedule optimizer specification: " << spec << " ([min|round[,<switch radix>]:]<path>). Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+}
+
+/**
+ * @brief Search the host order that suits the measured links best and write it as config (rank 0)
+ *
+ * Links not measured yet count with the mean of the measured ones. Due at every logging
+ * interval, performed at the end of the round so that no phase is timed around it.
+ */
+void ContinuousBenchmark::performScheduleOptimization()
+{
+    if (m_optimizedConfigPath.empty() || m_linkMatrix.empty())
+        return;
+
+    TimelineScope scope("schedule optimization");
+
+    const std::size_t units = std::min(m_readoutUnits.size(), m_builderUnits.size());
+
+    double measuredSum = 0.0;
+    std::size_t measured = 0;
+    for (std::size_t ru = 0; ru < units; ru++)
+    {
+        for (std::size_t bu = 0; bu < units; bu++)
+        {
+            if (m_linkMatrix.at(ru, bu).phases > 0)
+            {
+                measuredSum += m_linkMatrix.at(ru, bu).throughput;
+                measured++;
+            }
+        }
+    }
+
+    std::vector<double> throughput(units * units, measuredSum / measured);
+    for (std::size_t ru = 0; ru < units; ru++)
+    {
+        for (std::size_t bu = 0; bu < units; bu++)
+        {
+            if (m_linkMatrix.at(ru, bu).phases > 0)
+                throughput[ru * units + bu] = m_linkMatrix.at(ru, bu).throughput;
+        }
+    }
+
+    ScheduleOptimizer optimizer(throughput, units, m_optimizerObjective, m_optimizerRadix);
+    std::vector<std::size_t> order = optimizer.optimize(1);
+
+    std::vector<std::size_t> identity(units);
+    std::iota(identity.begin(), identity.end(), 0);
+
+    std::cout << std::fixed << std::setprecision(1) << std::endl
+              << "Schedule optimizer (" << ScheduleOptimizer::objectiveToString(m_optimizerObjective) << "): config order "
+              << optimizer.evaluate(identity) << " Mbit/s, optimized " << optimizer.evaluate(order) << " Mbit/s, host order";
+    for (std::size_t host : order)
+        std::cout << " " << m_unit->getPairHost(host);
+    std::cout << std::endl;
+
+    if (!writeConfigOrder(m_unit->getConfigPath(), m_optimizedConfigPath, order))
+        std::cerr << "Failed to write optimized config: " << m_optimizedConfigPath
+                  << " (config must hold one RU and one BU entry per host, no dummies)" << std::endl;
+}
+
+void ContinuousBenchmark::handleAverageThroughput(std::size_t transferredSize, double currentRunTimeDiff, timespec endTime, double cpuTime)
+{
+    TimelineScope scope("average throughput");
+
+    for (const auto &unit : m_builderUnits)
+    {
+        int buRank = unit.rank;
+
+        std::size_t tmpTransferredSize = 0;
+        double tmpElapsedTime = 0.0;
+        double tmpCpuTime = 0.0;
+
+        if (m_rank == 0 && buRank == 0) // 0 is one of the BUs
+        {
+            m_totalTransferredSize += transferredSize;
+            m_totalElapsedTime += currentRunTimeDiff;
+            m_totalCpuTime += cpuTime;
+        }
+        else if (m_rank == 0) // receive info from BUs
+        {
+            MPI_Recv(&tmpTransferredSize, 1, MPI_UNSIGNED_LONG_LONG, buRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            MPI_Recv(&tmpElapsedTime, 1, MPI_DOUBLE, buRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            MPI_Recv(&tmpCpuTime, 1, MPI_DOUBLE, buRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+            m_totalTransferredSize += tmpTransferredSize;
+            m_totalElapsedTime += tmpElapsedTime;
+            m_totalCpuTime += tmpCpuTime;
+        }
+        else if (m_rank == buRank) // send info from BUs to 0
         {
+            MPI_Send(&transferredSize, 1, MPI_UNSIGNED_LONG_LONG, 0, 0, MPI_COMM_WORLD);
+            MPI_Send(&currentRunTimeDiff, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+            MPI_Send(&cpuTime, 1, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+        }
+    }
+
+    if (m_transport) // the RUs' zero-copy sends the kernel fell back to copying
+    {
+        std::size_t copiedSends = m_transport->takeCopiedSends();
+        std::size_t totalCopiedSends = 0;
+        MPI_Reduce(&copiedSends, &totalCopiedSends, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        m_totalCopiedSends += totalCopiedSends;
+    }
+
+    if (m_rank == 0)
+    {
+        timespec lastAvgCalculationDiff = diff(m_lastAvgCalculationTime, endTime);
+        double secsFromLastAvg = lastAvgCalculationDiff.tv_sec + (lastAvgCalculationDiff.tv_nsec / 1e9);
+        if (secsFromLastAvg >= m_lastAvgCalculationInterval) // interval exceeded, perform logging
+        {
+            performPeriodicalLogging();
+            performLinkMatrixLogging();
+            performNodeLocalityLogging();
+            m_scheduleOptimizationDue = m_optimizedConfigPath.empty() ? 0 : 1;
+            m_totalTransferredSize = 0;
+            m_totalElapsedTime = 0.0;
+            m_totalCpuTime = 0.0;
+            m_totalCopiedSends = 0;
+            clock_gettime(CLOCK_MONOTONIC, &m_lastAvgCalculationTime);
+            return;
+        }
+    }
+}
+
+void ContinuousBenchmark::run()
+{
+    int ruRank, buRank;
+    std::string ruId, buId, ruHost, buHost;
+
+    timespec startTimeBarrier, endTime;
+    uint64_t startTicks;
+
+    m_barrierArrivals.clear();
+
+    if (m_schedule && m_schedule->changesPerRound())
+    {
+        m_schedule->beginRound(m_round);
+        m_unit->applySchedule(*m_schedule);
+    }
+
+    if (m_commType == COMM_INCAST)
+    {
+        runIncast();
+        performBarrierSkewLogging();
+        m_round++;
+        return;
+    }
+
+    if (m_commType == COMM_FIXED_FANOUT)
+    {
+        runFanOut();
+        performBarrierSkewLogging();
+        m_round++;
+        return;
+    }
+
+    if (m_commType == COMM_FIXED_PACED && m_rank == 0)
+        std::cout << "\nOffered load: " << m_eventRates[m_eventRateIndex] << " fragments/s per RU ("
+                  << m_eventRates[m_eventRateIndex] * m_messageSize * 8.0 / 1e6 << " Mbit/s)" << std::endl;
+
+    std::pair<std::size_t, std::size_t> result = std::make_pair(0, 0);
+
+    // odd rounds inject the faults, even ones are the baseline they are compared against
+    m_faultInjector.setActive(m_round % 2 == 1);
+    std::size_t roundTransferredSize = 0;
+    uint64_t roundStart = CycleTimer::now();
+
+    for (int phase = 0; phase < m_nodesCount / 2; phase++)
+    {
+        TimelineScope phaseScope("phase", phase);
+
+        PhaseTiming phaseTiming;
+        phaseTiming.phase = phase;
+
+        clock_gettime(CLOCK_MONOTONIC, &startTimeBarrier);
+        {
+            TimelineScope barrierScope("barrier", phase);
+            if (ClockSync::isEnabled())
+                m_barrierArrivals.push_back(ClockSync::now());
+            uint64_t barrierStart = CycleTimer::now();
+            MPI_Barrier(MPI_COMM_WORLD);
+            phaseTiming.barrierWait = CycleTimer::toSeconds(CycleTimer::now() - barrierStart);
+        }
+        CpuUsage cpuStart = CpuUsage::now();
+        phaseTiming.start = phaseTiming.end = phaseClock();
+
+        // paced fragments are due relative to one start shared by RU and BU
+        double pacedPhaseStart = phaseTiming.start;
+        if (m_commType == COMM_FIXED_PACED && ClockSync::isEnabled())
+            MPI_Allreduce(MPI_IN_PLACE, &pacedPhaseStart, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        if (m_rank == 0)
+            std::cout << "\n\n===========================================================================\n\n"
+                      << std::endl;
+
+        if (m_unit->getUnitType() == UnitType::RU)
+        {
+            ruRank = m_rank;
+            ruId = m_unit->getId();
+            ruHost = m_unit->getHostname();
+
+            buRank = m_builderUnits.at(m_unit->getPair(phase)).rank;
+            buId = (buRank == -1) ? "-1" : m_builderUnits.at(m_unit->getPair(phase)).id;
+            buHost = (buRank == -1) ? "DUMMY" : m_unit->getPairHost(m_unit->getPair(phase));
+        }
+        else if (m_unit->getUnitType() == UnitType::BU)
+        {
+            buRank = m_rank;
+            buId = m_unit->getId();
+            buHost = m_unit->getHostname();
+
+            ruRank = m_readoutUnits.at(m_unit->getPair(phase)).rank;
+            ruId = (ruRank == -1) ? "-1" : m_readoutUnits.at(m_unit->getPair(phase)).id;
+            ruHost = (ruRank == -1) ? "DUMMY" : m_unit->getPairHost(m_unit->getPair(phase));
+        }
+
+        // perform communication
+        timespec elapsedTime;
+        std::size_t errorMessageCount = 0;
+        std::size_t transferredSize = 0;
+        std::size_t sentSize = 0; // RU side, for per-rank counters
+        CpuUsage phaseCpu;
+        double currentRunTimeDiff = 0.0, currentRunTimeDiffBarrier = 0.0;
+
+        std::vector<double> trialThroughputs;
+        std::vector<double> latencies, oneWayLatencies;
+        std::vector<RailStatistics> railStatistics, phaseRailStatistics(m_railComms.size());
+
+        // BU side of non-blocking modes: last completion of previous phase to first of this one
+        bool measureGap = (m_rank == buRank) && (m_commType == COMM_FIXED_NONBLOCKING || m_commType == COMM_FIXED_PIPELINED);
+        double phaseSwitchGap = -1.0;
+
+        if (ruRank != -1 && buRank != -1) // skip communication involving dummy nodes
+        {
+            // ranks within the communicator of the phase
+            int commRuRank = communicatorRank(ruRank, UnitType::RU);
+            int commBuRank = communicatorRank(buRank, UnitType::BU);
+            int commRank = (m_rank == ruRank) ? commRuRank : commBuRank;
+            setCommunicator(phaseCommunicator(phase));
+
+            // fragments carry their global send time in the first bytes
+            // co-located pairs of the shared-memory mode bypass MPI point-to-point
+            bool handOff = m_sharedMemory && isIntraNode(ruRank, buRank);
+
+            bool measureOneWay = ClockSync::isEnabled() && m_messageSize >= sizeof(double) && !handOff && !m_transport &&
+                                 (m_commType == COMM_FIXED_BLOCKING || m_commType == COMM_FIXED_PACED);
+            setOneWayLatencies(measureOneWay ? &oneWayLatencies : nullptr);
+
+            m_faultInjector.selectPhase(m_rank, m_rank == ruRank, ruId, buId);
+
+            HardwareCounterValues countersStart = m_hardwareCounters.read();
+
+            for (std::size_t trial = 0; trial < m_trials; trial++)
+            {
+                std::size_t trialTransferredSize = 0;
+                double trialRunTimeDiff = 0.0;
+
+                for (int message = 0; message < m_messagesPerPhase; message++)
+                {
+                    TimelineScope batchScope("batch", message);
+                    startTicks = CycleTimer::now();
+
+                    m_faultInjector.delayBatch(m_iterations);
+
+                    if (handOff)
+                        result = CommunicationInterface::sharedMemoryCommunication(commRuRank, commBuRank, commRank,
+                                                                                   m_sharedSegments[ruRank], m_ruBufferBytes, m_sharedWindow,
+                                                                                   m_messageSize, m_iterations);
+
+                    else if (m_commType == COMM_FIXED_BLOCKING)
+                        result = transport().blockingCommunication(m_unit.get(), commRuRank, commBuRank, commRank, m_messageSize, m_iterations);
+
+                    else if (m_commType == COMM_FIXED_NONBLOCKING)
+                        result = transport().nonBlockingCommunication(m_unit.get(), commRuRank, commBuRank, commRank, m_messageSize, m_iterations);
+
+                    else if (m_commType == COMM_FIXED_PIPELINED && m_rank == buRank)
+                        result = receivePipelined(phase, trial * m_messagesPerPhase + message);
+
+                    else if (m_commType == COMM_FIXED_PIPELINED)
+                        result = CommunicationInterface::nonBlockingCommunication(m_unit.get(), commRuRank, commBuRank, commRank, m_messageSize, m_iterations);
+
+                    else if (m_commType == COMM_FIXED_PARTITIONED)
+                        result = CommunicationInterface::partitionedCommunication(m_unit.get(), commRuRank, commBuRank, commRank, m_messageSize, m_iterations,
+                                                                                  m_partitions, m_readoutRate);
+
+                    else if (m_commType == COMM_FIXED_STRIPED)
+                    {
+                        result = CommunicationInterface::stripedCommunication(m_unit.get(), ruRank, buRank, m_rank, m_messageSize, m_iterations,
+                                                                              m_stripeSize, m_railComms, railStatistics);
+                        for (std::size_t rail = 0; rail < railStatistics.size(); rail++)
+                        {
+                            phaseRailStatistics[rail].transferredSize += railStatistics[rail].transferredSize;
+                            phaseRailStatistics[rail].errors += railStatistics[rail].errors;
+                            phaseRailStatistics[rail].elapsedTime += railStatistics[rail].elapsedTime;
+                        }
+                    }
+
+                    else if (m_commType == COMM_VARIABLE_BLOCKING)
+                        result = transport().variableBlockingCommunication(m_unit.get(), commRuRank, commBuRank, commRank, m_messageSizes, m_iterations, message * m_iterations);
+
+                    else if (m_commType == COMM_VARIABLE_NONBLOCKING)
+                        result = transport().variableNonBlockingCommunication(m_unit.get(), commRuRank, commBuRank, commRank, m_messageSizes, m_iterations, message * m_iterations);
+
+                    else if (m_commType == COMM_FIXED_PACED)
+                        result = CommunicationInterface::pacedCommunication(m_unit.get(), commRuRank, commBuRank, commRank, m_messageSize, m_iterations,
+                                                                            m_eventRates[m_eventRateIndex], pacedPhaseStart,
+                                                                            (trial * m_messagesPerPhase + message) * m_iterations, latencies);
+
+                    else if (m_commType == COMM_TRACE_REPLAY)
+                        result = CommunicationInterface::traceReplayCommunication(m_unit.get(), commRuRank, commBuRank, commRank, m_traceReplay.get(),
+                                                                                  std::min(m_ruBufferBytes, m_buBufferBytes), m_iterations);
+
+                    m_faultInjector.throttleBatch(startTicks, result.second);
+
+                    // perform logging and reset result variable
+                    if (m_rank == buRank)
+                    {
+                        errorMessageCount += result.first;
+                        transferredSize += result.second;
+                        trialTransferredSize += result.second;
+
+                        result = std::make_pair(0, 0);
+                    }
+                    else if (m_rank == ruRank)
+                    {
+                        sentSize += result.second;
+                        result = std::make_pair(0, 0);
+                    }
+
+                    trialRunTimeDiff += CycleTimer::toSeconds(CycleTimer::now() - startTicks);
+
+                    if (measureGap && trial == 0 && message == 0 && m_previousPhaseEnd != 0)
+                        phaseSwitchGap = CycleTimer::toSeconds(getFirstCompletionTime() - m_previousPhaseEnd);
+                }
+
+                currentRunTimeDiff += trialRunTimeDiff;
+                trialThroughputs.push_back((trialTransferredSize * 8.0) / (trialRunTimeDiff * 1e6));
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &endTime);
+            phaseCpu = CpuUsage::now() - cpuStart;
+
+            bool isBu = (m_rank == buRank);
+            phaseTiming.end = phaseClock();
+            phaseTiming.role = isBu ? 1 : 0;
+            phaseTiming.peer = isBu ? ruRank : buRank;
+            phaseTiming.busyTime = currentRunTimeDiff;
+            phaseTiming.bytes = isBu ? transferredSize : sentSize;
+            performCpuUsageLogging(communicationTypeToString(m_commType), messageSizeToString(m_commType, m_messageSize), phase,
+                                   isBu ? buId : ruId, isBu ? ruId : buId, isBu ? transferredSize : sentSize,
+                                   m_iterations * m_messagesPerPhase * m_trials, currentRunTimeDiff, phaseCpu);
+
+            if (m_hardwareCounters.isOpen())
+                performCounterLogging(communicationTypeToString(m_commType), messageSizeToString(m_commType, m_messageSize), phase,
+                                      isBu ? buId : ruId, isBu ? ruId : buId, isBu ? transferredSize : sentSize, currentRunTimeDiff,
+                                      m_hardwareCounters.read() - countersStart);
+
+            elapsedTime = diff(startTimeBarrier, endTime);
+            currentRunTimeDiffBarrier = (elapsedTime.tv_sec + (elapsedTime.tv_nsec / 1e9));
+
+            if (measureGap)
+                m_previousPhaseEnd = getLastCompletionTime();
+
+            setOneWayLatencies(nullptr);
+        }
+        else
+        {
+            m_previousPhaseEnd = 0; // no gap across dummy phases
+        }
+
+        if ((m_rank == buRank) || (buRank == -1))
+        {
+            TimelineScope loggingScope("logging", phase);
+
             if (ruRank == -1 || buRank == -1)
             {
                 performPhaseLogging(ruId, buId, ruHost, buHost, phase, 0, 0, 0);
             }
-            else if (m_commType == COMM_VARIABLE_BLOCKING || m_commType == COMM_VARIABLE_NONBLOCKING)
+            else if (m_commType == COMM_VARIABLE_BLOCKING || m_commType == COMM_VARIABLE_NONBLOCKING || m_commType == COMM_TRACE_REPLAY)
             {
                 double avgThroughput = (transferredSize * 8.0) / (currentRunTimeDiff * 1e6);
                 double avgThroughputBarrier = (transferredSize * 8.0) / (currentRunTimeDiffBarrier * 1e6);
                 performPhaseLogging(ruId, buId, ruHost, buHost, phase, avgThroughput, avgThroughputBarrier, errorMessageCount);
             }
-            else if (m_commType == COMM_FIXED_BLOCKING || m_commType == COMM_FIXED_NONBLOCKING)
+            else if (isFixedSize(m_commType))
             {
                 double avgThroughput = (transferredSize * 8.0) / (currentRunTimeDiff * 1e6);
                 double avgThroughputBarrier = (transferredSize * 8.0) / (currentRunTimeDiffBarrier * 1e6);
-                double averageRtt = currentRunTimeDiff / (m_iterations * m_messagesPerPhase);
+                double averageRtt = currentRunTimeDiff / (m_iterations * m_messagesPerPhase * m_trials);
                 performPhaseLogging(ruId, buId, ruHost, buHost, phase, avgThroughput, avgThroughputBarrier, errorMessageCount, averageRtt);
             }
+
+            if (m_commType == COMM_FIXED_STRIPED && ruRank != -1 && buRank != -1)
+                performRailLogging(ruId, buId, phase, phaseRailStatistics);
+
+            if (phaseSwitchGap >= 0)
+                performPhaseSwitchLogging(ruId, buId, phase, phaseSwitchGap);
+
+            if (m_commType == COMM_FIXED_PACED && ruRank != -1 && buRank != -1)
+            {
+                double avgThroughput = (transferredSize * 8.0) / (currentRunTimeDiff * 1e6);
+                performLatencyLogging(ruId, buId, phase, m_eventRates[m_eventRateIndex], avgThroughput, latencies);
+            }
+
+            if (!oneWayLatencies.empty())
+                performOneWayLatencyLogging(ruId, buId, phase, oneWayLatencies);
+
+            if (m_trials > 1 && ruRank != -1 && buRank != -1)
+            {
+                TrialStatistics stats = computeTrialStatistics(trialThroughputs);
+                std::cout << std::fixed << std::setprecision(2)
+                          << "Trials: " << stats.trials << " (" << stats.outliers << " outliers)"
+                          << " | mean " << stats.mean << " Mbit/s"
+                          << " | median " << stats.median << " Mbit/s"
+                          << " | stddev " << stats.stddev << " Mbit/s"
+                          << " | 95% CI [" << stats.ciLow << ", " << stats.ciHigh << "] Mbit/s" << std::endl
+                          << std::endl;
+
+                performTrialLogging(communicationTypeToString(m_commType), messageSizeToString(m_commType, m_messageSize),
+                                    phase, ruId, buId, stats);
+            }
         }
 
-        handleAverageThroughput(transferredSize, currentRunTimeDiffBarrier, endTime);
+        handleLinkMatrix(m_rank == buRank ? m_unit->getPair(phase) : -1, transferredSize, currentRunTimeDiff, errorMessageCount);
+        handleAverageThroughput(transferredSize, currentRunTimeDiffBarrier, endTime, phaseCpu.processTime());
+        roundTransferredSize += transferredSize;
+
+        m_stragglerDetector.record(phaseTiming);
+        m_stragglerDetector.progress();
+
+        if (m_traceRecorder)
+            m_traceRecorder->flush();
     }
+
+    setCommunicator(MPI_COMM_WORLD);
+
+    performBarrierSkewLogging();
+
+    if (!m_faultInjector.empty())
+        performFaultInjectionLogging(roundTransferredSize, roundStart);
+
+    // the previous round's timings, gathered while this one ran
+    std::string configHost = m_unit->getConfigHostname();
+    if (m_stragglerDetector.submit(configHost.empty() ? m_hostname : configHost, m_unit->getNetworkDevice()))
+        performStragglerLogging(m_round - 1);
+
+    // paced mode sweeps the offered load, one rate per round of phases (per baseline and injected pair with faults)
+    if (m_commType == COMM_FIXED_PACED && (m_faultInjector.empty() || m_faultInjector.isActive()))
+        m_eventRateIndex = (m_eventRateIndex + 1) % m_eventRates.size();
+
+    // the search takes seconds, so it runs between rounds and the barrier keeps it out of the next round's first phase
+    if (!m_optimizedConfigPath.empty())
+    {
+        MPI_Bcast(&m_scheduleOptimizationDue, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (m_scheduleOptimizationDue)
+        {
+            if (m_rank == 0)
+                performScheduleOptimization();
+            m_scheduleOptimizationDue = 0;
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+    }
+
+    m_round++;
+}
+
+/**
+ * @brief Incast schedule: groups of m_fanIn RUs converge on one BU per phase
+ *
+ * RU r sends to BU (r / fanIn + phase) % BU count, so over one round every RU visits
+ * every BU once, and in each phase only the BUs facing a group receive.
+ */
+void ContinuousBenchmark::runIncast()
+{
+    const int ruCount = m_readoutUnits.size();
+    const int buCount = m_builderUnits.size();
+    const int fanIn = m_fanIn;
+
+    timespec startTimeBarrier, endTime;
+
+    for (int phase = 0; phase < buCount; phase++)
+    {
+        TimelineScope phaseScope("phase", phase);
+
+        clock_gettime(CLOCK_MONOTONIC, &startTimeBarrier);
+        {
+            TimelineScope barrierScope("barrier", phase);
+            if (ClockSync::isEnabled())
+                m_barrierArrivals.push_back(ClockSync::now());
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+        CpuUsage cpuStart = CpuUsage::now();
+
+        if (m_rank == 0)
+            std::cout << "\n\n===========================================================================\n\n"
+                      << std::endl;
+
+        int group = -1, buIndex = -1;
+
+        if (m_unit->getUnitType() == UnitType::RU)
+        {
+            group = std::stoi(m_unit->getId()) / fanIn;
+            buIndex = (group + phase) % buCount;
+        }
+        else if (m_unit->getUnitType() == UnitType::BU)
+        {
+            buIndex = std::find_if(m_builderUnits.begin(), m_builderUnits.end(), [this](const UnitInfo &unit)
+                                   { return unit.rank == m_rank; }) -
+                      m_builderUnits.begin();
+            group = (buIndex - phase + buCount) % buCount;
+        }
+
+        std::vector<int> ruRanks;
+        for (int ru = group * fanIn; ru < std::min((group + 1) * fanIn, ruCount); ru++)
+            ruRanks.push_back(m_readoutUnits.at(ru).rank);
+
+        int buRank = m_builderUnits.at(buIndex).rank;
+
+        std::vector<SenderStatistics> phaseStatistics, messageStatistics;
+        std::size_t transferredSize = 0;
+
+        // statistics cover all batches of all trials of the phase
+        for (std::size_t trial = 0; trial < m_trials && !ruRanks.empty(); trial++)
+        {
+            for (std::size_t message = 0; message < m_messagesPerPhase; message++)
+            {
+                TimelineScope batchScope("batch", message);
+                std::pair<std::size_t, std::size_t> result = CommunicationInterface::incastCommunication(m_unit.get(), ruRanks, buRank, m_rank,
+                                                                                                         m_messageSize, m_iterations, messageStatistics);
+                transferredSize += result.second;
+
+                if (phaseStatistics.empty())
+                {
+                    phaseStatistics = std::move(messageStatistics);
+                    continue;
+                }
+
+                for (std::size_t sender = 0; sender < messageStatistics.size(); sender++)
+                {
+                    SenderStatistics &total = phaseStatistics[sender];
+                    total.transferredSize += messageStatistics[sender].transferredSize;
+                    total.errors += messageStatistics[sender].errors;
+                    total.elapsedTime += messageStatistics[sender].elapsedTime;
+                    total.latencies.insert(total.latencies.end(), messageStatistics[sender].latencies.begin(),
+                                           messageStatistics[sender].latencies.end());
+                }
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &endTime);
+        CpuUsage phaseCpu = CpuUsage::now() - cpuStart;
+        timespec elapsedTime = diff(startTimeBarrier, endTime);
+        double currentRunTimeDiffBarrier = elapsedTime.tv_sec + (elapsedTime.tv_nsec / 1e9);
+
+        if (m_rank == buRank && !ruRanks.empty())
+        {
+            TimelineScope loggingScope("logging", phase);
+            performIncastLogging(m_unit->getId(), m_unit->getHostname(), phase, phaseStatistics);
+        }
+
+        handleAverageThroughput((m_rank == buRank) ? transferredSize : 0, currentRunTimeDiffBarrier, endTime, phaseCpu.processTime());
+    }
+}
+
+/**
+ * @brief Fan-out schedule: every unit talks to m_fanOut peers per phase
+ *
+ * The peers of a phase are the pairs of phases phase .. phase + m_fanOut - 1 of the shift
+ * schedule, so RU r sends to the BUs it would otherwise visit one at a time and every BU
+ * receives from the matching RUs. Dummy peers are skipped.
+ */
+void ContinuousBenchmark::runFanOut()
+{
+    const int phases = m_nodesCount / 2;
+    const bool isRu = m_unit->getUnitType() == UnitType::RU;
+
+    timespec startTimeBarrier, endTime, elapsedTime;
+
+    for (int phase = 0; phase < phases; phase++)
+    {
+        TimelineScope phaseScope("phase", phase);
+
+        clock_gettime(CLOCK_MONOTONIC, &startTimeBarrier);
+        {
+            TimelineScope barrierScope("barrier", phase);
+            if (ClockSync::isEnabled())
+                m_barrierArrivals.push_back(ClockSync::now());
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+        CpuUsage cpuStart = CpuUsage::now();
+
+        if (m_rank == 0)
+            std::cout << "\n\n===========================================================================\n\n"
+                      << std::endl;
+
+        std::vector<int> peerRanks;
+        std::string peerIds, peerHosts;
+
+        for (std::size_t offset = 0; offset < m_fanOut; offset++)
+        {
+            int pair = m_unit->getPair((phase + offset) % phases);
+            if (pair == -1)
+                continue;
+
+            const UnitInfo &peer = isRu ? m_builderUnits.at(pair) : m_readoutUnits.at(pair);
+            peerRanks.push_back(peer.rank);
+            peerIds += (peerIds.empty() ? "" : "+") + peer.id;
+            peerHosts += (peerHosts.empty() ? "" : "+") + m_unit->getPairHost(pair);
+        }
+
+        std::size_t errorMessageCount = 0;
+        std::size_t transferredSize = 0;
+        double currentRunTimeDiff = 0.0;
+
+        if (!peerRanks.empty())
+        {
+            for (std::size_t message = 0; message < m_messagesPerPhase; message++)
+            {
+                TimelineScope batchScope("batch", message);
+                uint64_t startTicks = CycleTimer::now();
+
+                std::pair<std::size_t, std::size_t> result = CommunicationInterface::fanOutCommunication(m_unit.get(), peerRanks,
+                                                                                                         m_messageSize, m_iterations);
+                errorMessageCount += result.first;
+                transferredSize += result.second;
+
+                currentRunTimeDiff += CycleTimer::toSeconds(CycleTimer::now() - startTicks);
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &endTime);
+        CpuUsage phaseCpu = CpuUsage::now() - cpuStart;
+        elapsedTime = diff(startTimeBarrier, endTime);
+        double currentRunTimeDiffBarrier = elapsedTime.tv_sec + (elapsedTime.tv_nsec / 1e9);
+
+        if (!isRu)
+        {
+            TimelineScope loggingScope("logging", phase);
+
+            if (peerRanks.empty())
+            {
+                performPhaseLogging("-1", m_unit->getId(), "DUMMY", m_unit->getHostname(), phase, 0, 0, 0);
+            }
+            else
+            {
+                double avgThroughput = (transferredSize * 8.0) / (currentRunTimeDiff * 1e6);
+                double avgThroughputBarrier = (transferredSize * 8.0) / (currentRunTimeDiffBarrier * 1e6);
+                double averageRtt = currentRunTimeDiff / (m_iterations * m_messagesPerPhase);
+                performPhaseLogging(peerIds, m_unit->getId(), peerHosts, m_unit->getHostname(), phase,
+                                    avgThroughput, avgThroughputBarrier, errorMessageCount, averageRtt);
+            }
+        }
+
+        handleAverageThroughput(transferredSize, currentRunTimeDiffBarrier, endTime, phaseCpu.processTime());
+
+        if (m_traceRecorder)
+            m_traceRecorder->flush();
+    }
+}
+
+void ContinuousBenchmark::performIncastLogging(std::string buId, std::string buHost, int phase, const std::vector<SenderStatistics> &senderStatistics)
+{
+    std::size_t totalTransferredSize = 0, totalErrors = 0;
+    double totalElapsedTime = 0.0;
+    std::vector<double> allLatencies;
+
+    // one-way latencies with synchronised clocks, else service times (see incastCommunication())
+    const bool oneWay = stampsSendTime(m_messageSize);
+    const std::string measure = oneWay ? "One-way" : "Service";
+    const std::string column = oneWay ? "one_way" : "service_time";
+
+    std::cout << std::right << std::setw(7) << "Phase"
+              << " | " << std::setw(7) << "RU"
+              << " | " << std::setw(7) << "BU"
+              << " | " << std::setw(20) << "Throughput"
+              << " | " << std::setw(14) << measure + " p50"
+              << " | " << std::setw(14) << measure + " p99"
+              << " | " << std::setw(14) << measure + " max"
+              << " | " << std::setw(8) << "Errors" << std::endl;
+
+    std::ofstream outputFile(m_incastFilepath, std::ios::app);
+    if (outputFile.is_open())
+    {
+        outputFile.seekp(0, std::ios::end);
+        if (outputFile.tellp() == 0)
+        {
+            outputFile << "timestamp,message_size,fan_in,phase,bu,bu_host,ru,ru_host,throughput,"
+                       << column << "_p50," << column << "_p99," << column << "_max,errors\n";
+        }
+    }
+    else
+    {
+        std::cerr << "Failed to open file: " << m_incastFilepath << std::endl;
+    }
+
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+    auto logRow = [&](std::string ruId, std::string ruHost, double throughput, const std::vector<double> &latencies, std::size_t errors)
+    {
+        double p50 = percentile(latencies, 0.5);
+        double p99 = percentile(latencies, 0.99);
+        double maxLatency = latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end());
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::right << std::setw(7) << phase
+                  << " | " << std::setw(7) << ruId
+                  << " | " << std::setw(7) << buId
+                  << " | " << std::setw(13) << throughput << " Mbit/s"
+                  << " | " << std::setw(11) << p50 * 1e6 << " us"
+                  << " | " << std::setw(11) << p99 * 1e6 << " us"
+                  << " | " << std::setw(11) << maxLatency * 1e6 << " us"
+                  << " | " << std::setw(8) << errors << std::endl;
+
+        if (outputFile.is_open())
+        {
+            outputFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << ","
+                       << m_messageSize << ","
+                       << m_fanIn << ","
+                       << phase << ","
+                       << buId << ","
+                       << buHost << ","
+                       << ruId << ","
+                       << ruHost << ","
+                       << std::fixed << std::setprecision(1) << throughput << ","
+                       << std::setprecision(8) << p50 << ","
+                       << p99 << ","
+                       << maxLatency << ","
+                       << errors << "\n";
+        }
+    };
+
+    for (const SenderStatistics &sender : senderStatistics)
+    {
+        int ruIndex = std::find_if(m_readoutUnits.begin(), m_readoutUnits.end(), [&sender](const UnitInfo &unit)
+                                   { return unit.rank == sender.rank; }) -
+                      m_readoutUnits.begin();
+        logRow(m_readoutUnits.at(ruIndex).id, m_unit->getPairHost(ruIndex),
+               (sender.transferredSize * 8.0) / (sender.elapsedTime * 1e6), sender.latencies, sender.errors);
+
+        totalTransferredSize += sender.transferredSize;
+        totalErrors += sender.errors;
+        totalElapsedTime = std::max(totalElapsedTime, sender.elapsedTime);
+        allLatencies.insert(allLatencies.end(), sender.latencies.begin(), sender.latencies.end());
+    }
+
+    logRow("ALL", "", (totalTransferredSize * 8.0) / (totalElapsedTime * 1e6), allLatencies, totalErrors);
+    std::cout << std::endl;
 }
@@ -4,6 +4,10 @@
 #include <fstream>
 
 #include "benchmark.h"
+#include "../traffic/fault_injection.h"
+#include "../statistics/straggler_detector.h"
+#include "../statistics/link_matrix.h"
+#include "../schedule/schedule_optimizer.h"
 
 struct UnitInfo
 {
@@ -11,23 +15,61 @@ struct UnitInfo
     std::string id;
 };
 
+enum CommunicatorScope
+{
+    SCOPE_WORLD, // all traffic on MPI_COMM_WORLD
+    SCOPE_PHASE, // one duplicate of MPI_COMM_WORLD per phase
+    SCOPE_PAIR   // one two-rank communicator per RU/BU pair (RU = 0, BU = 1)
+};
+
 class ContinuousBenchmark : public Benchmark
 {
 public:
     void run() override;
     void performWarmup() override;
+    void releaseResources() override;
+    void runIncast();
+    void runFanOut();
     void warmupCommunication(std::vector<std::pair<int, int>> subarrayIndices, int ruRank, int buRank) override;
 
 protected:
     void initUnitLists();
+    void initTrafficTrace();
+    void initCommunicators();
+    void initSchedule();
+    void initNicPlacement();
+    void initNodeLocality();
+    bool isIntraNode(int rankA, int rankB) const { return m_nodeOfRank[rankA] == m_nodeOfRank[rankB]; }
+    void parseCommunicatorScope(const std::string &scope);
+    std::string describeMatching();
+    MPI_Comm phaseCommunicator(int phase);
+    int communicatorRank(int rank, UnitType type);
+    int pairRank(int phase);
+    std::pair<std::size_t, std::size_t> receivePipelined(int phase, std::size_t batch);
     void performPhaseLogging(std::string ruId, std::string buId, std::string ruHost, std::string buHost, int phase,  
                              double throughput, double throughputBarrier, std::size_t errors, double averageRtt);
-    void handleAverageThroughput(std::size_t transferredSize, double currentRunTimeDiff, timespec endTime);
+    void handleAverageThroughput(std::size_t transferredSize, double currentRunTimeDiff, timespec endTime, double cpuTime);
     void performPeriodicalLogging();
+    void handleLinkMatrix(int ruIndex, std::size_t transferredSize, double currentRunTimeDiff, std::size_t errors);
+    void performLinkMatrixLogging();
+    void performNodeLocalityLogging();
+    void setScheduleOptimizer(const std::string &spec);
+    void performScheduleOptimization();
+    void performIncastLogging(std::string buId, std::string buHost, int phase, const std::vector<SenderStatistics> &senderStatistics);
+    void performRailLogging(std::string ruId, std::string buId, int phase, const std::vector<RailStatistics> &railStatistics);
+    void performPhaseSwitchLogging(std::string ruId, std::string buId, int phase, double gap);
+    void performLatencyLogging(std::string ruId, std::string buId, int phase, double eventRate, double throughput,
+                               const std::vector<double> &latencies);
+    void performOneWayLatencyLogging(std::string ruId, std::string buId, int phase, const std::vector<double> &latencies);
+    void performBarrierSkewLogging();
+    void performPlacementLogging();
+    void performFaultInjectionLogging(std::size_t roundTransferredSize, uint64_t roundStart);
+    void addFaultSpec(const std::string &spec);
+    void performStragglerLogging(std::size_t round);
 
     CommunicationType m_commType = COMM_UNDEFINED;
     std::size_t m_messageSize = -1;
-    std::vector<std::size_t> m_messageSizes;
+    std::vector<std::size_t> m_messageSizes; // pre-generated size of every event in a phase
     std::size_t m_messagesPerPhase = 1;
 
     const std::size_t minMessageSize = 1e4;
@@ -44,9 +86,68 @@ protected:
 
     std::size_t m_totalTransferredSize = 0;
     double m_totalElapsedTime = 0.0;
+    double m_totalCpuTime = 0.0; // s, of the BUs
+    std::size_t m_totalCopiedSends = 0; // zero-copy sends of the RUs the kernel copied, -X tcp-zerocopy
+
+    LinkMatrix m_linkMatrix; // rank 0, per RU/BU pair, dumped with the average throughput
+
+    std::size_t m_localityTransferredSize[2] = {0, 0}; // rank 0, inter-node [0] and intra-node [1] pairs, per logging interval
+    double m_localityElapsedTime[2] = {0.0, 0.0};
 
     std::size_t m_lastAvgCalculationInterval = 5;
     timespec m_lastAvgCalculationTime;
+
+    std::vector<MPI_Request> m_pipelinedRequests; // pipelined mode: receives posted ahead for the next batch
+    int m_pipelinedHalf = 0;                     // buffer half the posted batch lands in
+    uint64_t m_previousPhaseEnd = 0;              // last completion of the previous phase (BU), CycleTimer ticks
+
+    StragglerDetector m_stragglerDetector; // every rank's phase timings, gathered to rank 0 one round late
+    std::vector<double> m_barrierArrivals; // clock sync: global time this rank entered each phase barrier of the round
+
+    std::size_t m_fanIn = 1;  // incast mode: RUs sending to one BU at once
+    std::size_t m_fanOut = 1; // fan-out mode: peers of every unit per phase
+
+    std::string m_scheduleSpec = "linear";
+    std::unique_ptr<ScheduleGenerator> m_schedule; // pairs of every phase, applied to the unit's shift
+
+    std::string m_optimizedConfigPath; // rank 0 rewrites it with the best host order after a round, once per logging interval
+    int m_scheduleOptimizationDue = 0; // set by rank 0 at a logging interval, broadcast at the end of the round
+    ScheduleObjective m_optimizerObjective = OBJECTIVE_ROUND;
+    std::size_t m_optimizerRadix = 0; // hosts per leaf switch, 0 = any swap
+
+    CommunicatorScope m_communicatorScope = SCOPE_WORLD;
+    std::vector<MPI_Comm> m_phaseComms; // per phase, MPI_COMM_NULL where this unit idles
+
+    MPI_Comm m_nodeComm = MPI_COMM_NULL; // ranks sharing this rank's node (MPI_COMM_TYPE_SHARED)
+    std::vector<int> m_nodeOfRank;       // lowest world rank of every rank's node
+    std::size_t m_colocatedPairs = 0;    // RU/BU pairs on the same node
+
+    bool m_sharedMemory = false;          // co-located pairs hand over fragments of the RU's shared segment by offset
+    MPI_Win m_sharedWindow = MPI_WIN_NULL; // one segment of m_ruBufferBytes per RU of the node
+    std::vector<int8_t *> m_sharedSegments; // per world rank, RUs of this node only
+
+    bool m_nicPinning = false; // pin to the CPUs and bind the buffer to the NUMA node of the configured ibdev
+    NicLocality m_nicLocality;
+    bool m_cpuBound = false;
+
+    std::size_t m_partitions = 0; // partitioned mode: partitions per fragment
+    double m_readoutRate = 0.0;   // partitioned mode: Mbit/s the simulated readout fills fragments at, 0 = unpaced
+
+    std::size_t m_stripeSize = 0;   // striped mode: bytes of a fragment per rail stripe
+    std::size_t m_railCount = 2;
+    std::vector<MPI_Comm> m_railComms; // one duplicate of MPI_COMM_WORLD per rail
+
+    std::vector<double> m_eventRates; // paced mode: per-RU fragment rates (Hz), one per round
+    std::size_t m_eventRateIndex = 0;
+
+    FaultInjector m_faultInjector; // faults are injected every other round, the rounds in between are the baseline
+    std::size_t m_round = 0;
+    double m_baselineThroughput = 0.0; // Mbit/s, cluster-wide, of the last baseline round
+
+    std::string m_traceRecordPath; // "{ru}" is replaced by the RU id
+    std::string m_traceReplayPath;
+    std::unique_ptr<TraceWriter> m_traceRecorder;
+    std::unique_ptr<TraceReader> m_traceReplay;
 };
 
 #endif // CONTINUOUSBENCHMARK_H
\ No newline at end of file
@@ -16,6 +16,19 @@ BenchmarkFixedMessage::BenchmarkFixedMessage(std::vector<ArgumentEntry> args, Co
 
     parseArguments(args);
 
+    if (!m_eventRates.empty())
+        m_commType = COMM_FIXED_PACED;
+    else if (m_fanIn > 1)
+        m_commType = COMM_INCAST;
+    else if (m_fanOut > 1)
+        m_commType = COMM_FIXED_FANOUT;
+    else if (m_stripeSize > 0)
+        m_commType = COMM_FIXED_STRIPED;
+    else if (m_partitions > 0)
+        m_commType = COMM_FIXED_PARTITIONED;
+
+    m_fanOut = std::min<std::size_t>(m_fanOut, m_nodesCount / 2);
+
     if (m_rank == 0 && m_messageSize > m_ruBufferBytes)
     {
         std::cerr << "Message cannot exceed buffer. Exiting." << std::endl;
@@ -23,8 +36,117 @@ BenchmarkFixedMessage::BenchmarkFixedMessage(std::vector<ArgumentEntry> args, Co
         std::exit(1);
     }
 
+    if (m_commType == COMM_FIXED_PIPELINED && 2 * m_messageSize > m_buBufferBytes)
+    {
+        if (m_rank == 0)
+            std::cerr << "Pipelined mode needs a message to fit in half of the BU buffer. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (m_commType == COMM_INCAST && m_messageSize * m_fanIn > m_buBufferBytes)
+    {
+        if (m_rank == 0)
+            std::cerr << "BU buffer must hold one message per incast sender. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (m_commType == COMM_FIXED_FANOUT && m_messageSize * m_fanOut > m_buBufferBytes)
+    {
+        if (m_rank == 0)
+            std::cerr << "BU buffer must hold one message per fan-out peer. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (m_commType == COMM_FIXED_PARTITIONED && (m_messageSize % m_partitions != 0 || m_anySource))
+    {
+        if (m_rank == 0)
+            std::cerr << "Partitioned mode needs the message size to be a multiple of the partition count "
+                      << "and cannot receive from MPI_ANY_SOURCE. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    // the readout thread runs next to the thread driving MPI
+    int threadSupport;
+    MPI_Query_thread(&threadSupport);
+    if (m_commType == COMM_FIXED_PARTITIONED && threadSupport < MPI_THREAD_FUNNELED)
+    {
+        if (m_rank == 0)
+            std::cerr << "Partitioned mode needs MPI_THREAD_FUNNELED, the MPI library provides less. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if ((m_communicatorScope != SCOPE_WORLD || m_anySource) &&
+        (m_commType == COMM_INCAST || m_commType == COMM_FIXED_FANOUT || m_commType == COMM_FIXED_STRIPED))
+    {
+        if (m_rank == 0)
+            std::cerr << "Communicator scope and any-source receives apply to single-pair modes only. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (!m_faultInjector.empty() && (m_commType == COMM_INCAST || m_commType == COMM_FIXED_FANOUT))
+    {
+        if (m_rank == 0)
+            std::cerr << "Fault injection applies to single-pair modes only. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (m_transportSpec != "mpi" &&
+        ((m_commType != COMM_FIXED_BLOCKING && m_commType != COMM_FIXED_NONBLOCKING) ||
+         m_communicatorScope != SCOPE_WORLD || m_anySource || m_sharedMemory || !m_traceRecordPath.empty()))
+    {
+        if (m_rank == 0)
+            std::cerr << "Other transports than MPI run the blocking and non-blocking modes only, without "
+                      << "communicator scopes, any-source receives, shared memory or trace recording. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (m_sharedMemory && m_commType != COMM_FIXED_BLOCKING && m_commType != COMM_FIXED_NONBLOCKING)
+    {
+        if (m_rank == 0)
+            std::cerr << "Shared-memory hand-over applies to the blocking and non-blocking modes only. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (!m_optimizedConfigPath.empty() && (m_commType == COMM_INCAST || m_commType == COMM_FIXED_FANOUT))
+    {
+        if (m_rank == 0)
+            std::cerr << "The schedule optimizer needs the per-pair link matrix of single-pair modes. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (m_scheduleSpec != "linear" && m_commType == COMM_INCAST)
+    {
+        if (m_rank == 0)
+            std::cerr << "Incast mode picks its senders itself and ignores schedules. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
+    if (m_commType == COMM_FIXED_STRIPED)
+    {
+        m_railComms.resize(m_railCount);
+        for (MPI_Comm &rail : m_railComms)
+            MPI_Comm_dup(MPI_COMM_WORLD, &rail);
+    }
+
     initUnitLists();
+    initSchedule();
+    initCommunicators();
+    initNodeLocality();
+    initTransport();
+    initNicPlacement();
     m_unit->allocateMemory();
+    initTrafficTrace();
 
     if (m_rank == 0)
     {
@@ -32,7 +154,50 @@ BenchmarkFixedMessage::BenchmarkFixedMessage(std::vector<ArgumentEntry> args, Co
                   << "Performing fixed size benchmark. "
                   << std::endl;
 
-        if (commType == COMM_FIXED_BLOCKING)
+        if (m_commType == COMM_FIXED_PACED)
+        {
+            std::cout << "Paced open-loop communication, event rates (Hz):";
+            for (double rate : m_eventRates)
+                std::cout << " " << rate;
+            std::cout << std::endl
+                      << std::endl;
+        }
+        else if (m_commType == COMM_INCAST)
+        {
+            std::cout << "Incast communication, fan-in " << m_fanIn << "." << std::endl
+                      << std::endl;
+        }
+        else if (m_commType == COMM_FIXED_FANOUT)
+        {
+            std::cout << "Non-blocking fan-out communication, " << m_fanOut << " peers per phase." << std::endl
+                      << std::endl;
+        }
+        else if (m_commType == COMM_FIXED_PARTITIONED)
+        {
+#if MPI_VERSION >= 4
+            std::cout << "Partitioned communication (MPI_Psend_init), ";
+#else
+            std::cout << "Partitioned communication (per-partition persistent requests, MPI-4 not available), ";
+#endif
+            std::cout << m_partitions << " partitions per fragment, readout ";
+            if (m_readoutRate > 0)
+                std::cout << m_readoutRate << " Mbit/s." << std::endl;
+            else
+                std::cout << "unpaced." << std::endl;
+            std::cout << std::endl;
+        }
+        else if (m_commType == COMM_FIXED_STRIPED)
+        {
+            std::cout << "Non-blocking communication striped over " << m_railCount << " rail communicators, "
+                      << m_stripeSize << " B stripes." << std::endl
+                      << std::endl;
+        }
+        else if (m_commType == COMM_FIXED_PIPELINED)
+        {
+            std::cout << "Non-blocking communication, next phase's receives pre-posted." << std::endl
+                      << std::endl;
+        }
+        else if (commType == COMM_FIXED_BLOCKING)
         {
             std::cout << "Blocking communication." << std::endl
                       << std::endl;
@@ -54,6 +219,30 @@ BenchmarkFixedMessage::BenchmarkFixedMessage(std::vector<ArgumentEntry> args, Co
 
         std::cout << std::left << std::setw(20) << "Number of iterations:"
                   << std::right << std::setw(9) << m_iterations << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Number of trials:"
+                  << std::right << std::setw(10) << m_trials << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Matching:"
+                  << describeMatching() << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Transport:"
+                  << transport().describeTransport() << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Schedule:"
+                  << m_schedule->describe() << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Co-located pairs:"
+                  << m_colocatedPairs << " of " << m_readoutUnits.size() * m_builderUnits.size()
+                  << (m_sharedMemory ? ", handed over in shared memory" : "") << std::endl;
+
+        if (!m_optimizedConfigPath.empty())
+            std::cout << std::left << std::setw(20) << "Optimized config:"
+                      << m_optimizedConfigPath << " (" << ScheduleOptimizer::objectiveToString(m_optimizerObjective) << " objective)" << std::endl;
+
+        if (!m_faultInjector.empty())
+            std::cout << std::left << std::setw(20) << "Faults:"
+                      << m_faultInjector.describe() << std::endl;
     }
 
     clock_gettime(CLOCK_MONOTONIC, &m_lastAvgCalculationTime);
@@ -96,9 +285,75 @@ void BenchmarkFixedMessage::parseArguments(std::vector<ArgumentEntry> args)
             tmp = std::stoul(entry.value);
             m_lastAvgCalculationInterval = (tmp > 0) ? tmp : m_lastAvgCalculationInterval;
             break;
+        case 't':
+            tmp = std::stoul(entry.value);
+            m_trials = (tmp > 0) ? tmp : m_trials;
+            break;
+        case 'P':
+            m_commType = COMM_FIXED_PIPELINED;
+            break;
+        case 'k':
+            tmp = std::stoul(entry.value);
+            m_fanIn = (tmp > 0) ? tmp : m_fanIn;
+            break;
+        case 'F':
+            tmp = std::stoul(entry.value);
+            m_fanOut = (tmp > 0) ? tmp : m_fanOut;
+            break;
+        case 'q':
+            m_partitions = std::stoul(entry.value);
+            break;
+        case 'Q':
+            m_readoutRate = std::stod(entry.value);
+            break;
+        case 'S':
+            m_stripeSize = std::stoul(entry.value);
+            break;
+        case 'u':
+            tmp = std::stoul(entry.value);
+            m_railCount = (tmp > 0) ? tmp : m_railCount;
+            break;
+        case 'e':
+        {
+            std::istringstream rates(entry.value);
+            std::string rate;
+            while (std::getline(rates, rate, ','))
+            {
+                if (std::stod(rate) > 0)
+                    m_eventRates.push_back(std::stod(rate));
+            }
+            break;
+        }
+        case 'R':
+            m_traceRecordPath = entry.value;
+            break;
         case 'c':
             m_unit->setConfigPath(entry.value);
             break;
+        case 'g':
+            parseCommunicatorScope(entry.value);
+            break;
+        case 'a':
+            setAnySource(true);
+            break;
+        case 'N':
+            m_nicPinning = true;
+            break;
+        case 'D':
+            addFaultSpec(entry.value);
+            break;
+        case 'L':
+            m_scheduleSpec = entry.value;
+            break;
+        case 'X':
+            m_transportSpec = entry.value;
+            break;
+        case 'M':
+            m_sharedMemory = true;
+            break;
+        case 'O':
+            setScheduleOptimizer(entry.value);
+            break;
         default:
             if (m_rank == 0)
             {
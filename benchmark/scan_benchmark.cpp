@@ -24,6 +24,10 @@ ScanBenchmark::ScanBenchmark(std::vector<ArgumentEntry> args)
     m_rcvBufferBytes = m_rcvBufferSize * static_cast<std::size_t>(std::pow(2, m_maxPower));
 
     allocateMemory();
+    initTransport();
+
+    if (m_rank == 0)
+        std::cout << "Transport: " << transport().describeTransport() << std::endl;
 }
 
 void ScanBenchmark::allocateMemory()
@@ -76,6 +80,13 @@ void ScanBenchmark::parseArguments(std::vector<ArgumentEntry> args)
             tmp = std::stoul(entry.value);
             m_warmupIterations = (tmp > 0) ? tmp : m_warmupIterations;
             break;
+        case 't':
+            tmp = std::stoul(entry.value);
+            m_trials = (tmp > 0) ? tmp : m_trials;
+            break;
+        case 'X':
+            m_transportSpec = entry.value;
+            break;
         default:
             if (m_rank == 0)
             {
@@ -87,15 +98,27 @@ void ScanBenchmark::parseArguments(std::vector<ArgumentEntry> args)
     }
 }
 
-void ScanBenchmark::printRunInfo(std::size_t messageSize, double throughput)
+void ScanBenchmark::printRunInfo(std::size_t messageSize, const TrialStatistics &stats)
 {
     if (m_rank)
         return;
 
     std::cout << std::fixed << std::setprecision(2);
     std::cout << "| " << std::left << std::setw(12) << messageSize
-              << " | " << std::setw(19) << throughput
-              << " |\n";
+              << " | " << std::setw(19) << stats.mean;
+
+    if (m_trials > 1)
+    {
+        std::ostringstream interval;
+        interval << std::fixed << std::setprecision(2) << "[" << stats.ciLow << ", " << stats.ciHigh << "]";
+
+        std::cout << " | " << std::setw(12) << stats.median
+                  << " | " << std::setw(10) << stats.stddev
+                  << " | " << std::setw(25) << interval.str()
+                  << " | " << std::setw(8) << stats.outliers;
+    }
+
+    std::cout << " |\n";
 }
 
 void ScanBenchmark::warmupCommunication(std::vector<std::pair<int, int>> subarrayIndices, int ruRank, int buRank)
@@ -143,8 +166,8 @@ void ScanBenchmark::performWarmup()
     std::vector<std::pair<int, int>> subarrayIndices = findSubarrayIndices(m_sndBufferBytes);
 
     clock_gettime(CLOCK_MONOTONIC, &startTime);
-    std::pair<std::size_t, std::size_t> result = CommunicationInterface::twoRankBlockingCommunication(m_bufferSnd, m_bufferRcv, m_sndBufferBytes, m_rcvBufferBytes,
-                                                                                                      messageSize, m_rank, m_warmupIterations);
+    std::pair<std::size_t, std::size_t> result = transport().twoRankBlockingCommunication(m_bufferSnd, m_bufferRcv, m_sndBufferBytes, m_rcvBufferBytes,
+                                                                                           messageSize, m_rank, m_warmupIterations);
     transferredSize = result.second;
 
     clock_gettime(CLOCK_MONOTONIC, &endTime);
@@ -158,8 +181,8 @@ void ScanBenchmark::performWarmup()
     transferredSize = 0;
     clock_gettime(CLOCK_MONOTONIC, &startTime);
 
-    result = CommunicationInterface::twoRankBlockingCommunication(m_bufferSnd, m_bufferRcv, m_sndBufferBytes, m_rcvBufferBytes,
-                                                                  messageSize, m_rank, m_warmupIterations);
+    result = transport().twoRankBlockingCommunication(m_bufferSnd, m_bufferRcv, m_sndBufferBytes, m_rcvBufferBytes,
+                                                       messageSize, m_rank, m_warmupIterations);
     transferredSize = result.second;
     clock_gettime(CLOCK_MONOTONIC, &endTime);
 
@@ -176,8 +199,17 @@ void ScanBenchmark::run()
     {
         std::cout << std::fixed << std::setprecision(2);
         std::cout << "| " << std::left << std::setw(12) << "Bytes"
-                  << " | " << std::setw(18) << "Throughput [Mbit/s]"
-                  << " |\n";
+                  << " | " << std::setw(18) << "Throughput [Mbit/s]";
+
+        if (m_trials > 1)
+        {
+            std::cout << " | " << std::setw(12) << "Median"
+                      << " | " << std::setw(10) << "Stddev"
+                      << " | " << std::setw(25) << "95% CI"
+                      << " | " << std::setw(8) << "Outliers";
+        }
+
+        std::cout << " |\n";
         std::cout << "--------------------------------------\n";
     }
 
@@ -187,22 +219,50 @@ void ScanBenchmark::run()
 
     std::size_t currentMessageSize;
     std::size_t transferredSize;
+    std::vector<double> trialThroughputs(m_trials);
 
     for (std::size_t power = 0; power <= m_maxPower; power++)
     {
         currentMessageSize = static_cast<std::size_t>(std::pow(2, power));
-        transferredSize = 0;
-        clock_gettime(CLOCK_MONOTONIC, &startTime);
+        HardwareCounterValues countersStart = m_hardwareCounters.read();
+        CpuUsage cpuStart = CpuUsage::now();
+        std::size_t sizeTransferredSize = 0;
+        double sizeElapsedTime = 0.0;
+
+        for (std::size_t trial = 0; trial < m_trials; trial++)
+        {
+            TimelineScope sizeScope("message size", currentMessageSize);
+
+            transferredSize = 0;
+            clock_gettime(CLOCK_MONOTONIC, &startTime);
+
+            std::pair<std::size_t, std::size_t> result = transport().twoRankBlockingCommunication(m_bufferSnd, m_bufferRcv, m_sndBufferBytes, m_rcvBufferBytes,
+                                                                                                   currentMessageSize, m_rank, m_iterations);
+            errorMessageCount += result.first;
+            transferredSize = result.second;
+
+            clock_gettime(CLOCK_MONOTONIC, &endTime);
+            std::tie(std::ignore, avgThroughput) = calculateThroughput(startTime, endTime, transferredSize, m_iterations);
+
+            trialThroughputs[trial] = avgThroughput;
+            sizeTransferredSize += transferredSize;
+            timespec elapsedTime = diff(startTime, endTime);
+            sizeElapsedTime += elapsedTime.tv_sec + (elapsedTime.tv_nsec / 1e9);
+        }
+
+        if (m_rank < 2)
+            performCpuUsageLogging("SCAN", std::to_string(currentMessageSize), 0, std::to_string(m_rank), std::to_string(1 - m_rank),
+                                   sizeTransferredSize, m_iterations * m_trials, sizeElapsedTime, CpuUsage::now() - cpuStart);
 
-        std::pair<std::size_t, std::size_t> result = CommunicationInterface::twoRankBlockingCommunication(m_bufferSnd, m_bufferRcv, m_sndBufferBytes, m_rcvBufferBytes,
-                                                                                                          currentMessageSize, m_rank, m_iterations);
-        errorMessageCount += result.first;
-        transferredSize = result.second;
+        if (m_hardwareCounters.isOpen() && m_rank < 2)
+            performCounterLogging("SCAN", std::to_string(currentMessageSize), 0, std::to_string(m_rank), std::to_string(1 - m_rank),
+                                  sizeTransferredSize, sizeElapsedTime, m_hardwareCounters.read() - countersStart);
 
-        clock_gettime(CLOCK_MONOTONIC, &endTime);
-        std::tie(std::ignore, avgThroughput) = calculateThroughput(startTime, endTime, transferredSize, m_iterations);
+        TrialStatistics stats = computeTrialStatistics(trialThroughputs);
+        printRunInfo(currentMessageSize, stats);
 
-        printRunInfo(currentMessageSize, avgThroughput);
+        if (m_rank == 0 && m_trials > 1)
+            performTrialLogging("SCAN", std::to_string(currentMessageSize), 0, "0", "1", stats);
     }
 
     if (m_rank == 0)
@@ -17,7 +17,7 @@ public:
 private:
     void allocateMemory();
     void parseArguments(std::vector<ArgumentEntry> args) override;
-    void printRunInfo(std::size_t messageSize, double throughput);
+    void printRunInfo(std::size_t messageSize, const TrialStatistics &stats);
 
     std::size_t m_maxPower = 22;
 
@@ -15,8 +15,27 @@ BenchmarkVariableMessage::BenchmarkVariableMessage(std::vector<ArgumentEntry> ar
 
     BenchmarkVariableMessage::parseArguments(args);
 
+    if (!m_traceReplayPath.empty())
+        m_commType = COMM_TRACE_REPLAY;
+
+    if (m_transportSpec != "mpi" &&
+        (m_commType == COMM_TRACE_REPLAY || m_communicatorScope != SCOPE_WORLD || m_anySource || !m_traceRecordPath.empty()))
+    {
+        if (m_rank == 0)
+            std::cerr << "Other transports than MPI cannot replay or record traces, use communicator scopes "
+                      << "or any-source receives. Exiting." << std::endl;
+        MPI_Finalize();
+        std::exit(1);
+    }
+
     initUnitLists();
+    initSchedule();
+    initCommunicators();
+    initNodeLocality();
+    initTransport();
+    initNicPlacement();
     m_unit->allocateMemory();
+    initTrafficTrace();
 
     initMessageSizes();
 
@@ -36,7 +55,16 @@ BenchmarkVariableMessage::BenchmarkVariableMessage(std::vector<ArgumentEntry> ar
             std::cout << "Non-blocking communication." << std::endl
                       << std::endl;
         }
-        std::cout << "Available sizes: " << m_messageSizeVariants << " (range: 10000 B - " << m_ruBufferBytes << " B)" << std::endl;
+
+        if (m_commType == COMM_TRACE_REPLAY)
+        {
+            std::cout << "Replaying trace: " << m_traceReplayPath << std::endl;
+        }
+        else
+        {
+            std::cout << "Size distribution: " << m_sizeDistribution->describe() << std::endl;
+            std::cout << "Event correlation: " << m_sizeCorrelation << std::endl;
+        }
 
         std::cout << std::endl
                   << std::left << std::setw(20) << "RU buffer size:"
@@ -47,6 +75,30 @@ BenchmarkVariableMessage::BenchmarkVariableMessage(std::vector<ArgumentEntry> ar
 
         std::cout << std::left << std::setw(20) << "Number of iterations:"
                   << std::right << std::setw(9) << m_iterations << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Number of trials:"
+                  << std::right << std::setw(10) << m_trials << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Matching:"
+                  << describeMatching() << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Transport:"
+                  << transport().describeTransport() << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Schedule:"
+                  << m_schedule->describe() << std::endl;
+
+        std::cout << std::left << std::setw(20) << "Co-located pairs:"
+                  << m_colocatedPairs << " of " << m_readoutUnits.size() * m_builderUnits.size()
+                  << (m_sharedMemory ? ", handed over in shared memory" : "") << std::endl;
+
+        if (!m_optimizedConfigPath.empty())
+            std::cout << std::left << std::setw(20) << "Optimized config:"
+                      << m_optimizedConfigPath << " (" << ScheduleOptimizer::objectiveToString(m_optimizerObjective) << " objective)" << std::endl;
+
+        if (!m_faultInjector.empty())
+            std::cout << std::left << std::setw(20) << "Faults:"
+                      << m_faultInjector.describe() << std::endl;
     }
 
     clock_gettime(CLOCK_MONOTONIC, &m_lastAvgCalculationTime);
@@ -89,9 +141,46 @@ void BenchmarkVariableMessage::parseArguments(std::vector<ArgumentEntry> args)
             tmp = std::stoul(entry.value);
             m_lastAvgCalculationInterval = (tmp > 0) ? tmp : m_lastAvgCalculationInterval;
             break;
+        case 't':
+            tmp = std::stoul(entry.value);
+            m_trials = (tmp > 0) ? tmp : m_trials;
+            break;
+        case 'R':
+            m_traceRecordPath = entry.value;
+            break;
+        case 'T':
+            m_traceReplayPath = entry.value;
+            break;
         case 'c':
             m_unit->setConfigPath(entry.value);
             break;
+        case 'g':
+            parseCommunicatorScope(entry.value);
+            break;
+        case 'a':
+            setAnySource(true);
+            break;
+        case 'N':
+            m_nicPinning = true;
+            break;
+        case 'D':
+            addFaultSpec(entry.value);
+            break;
+        case 'L':
+            m_scheduleSpec = entry.value;
+            break;
+        case 'X':
+            m_transportSpec = entry.value;
+            break;
+        case 'O':
+            setScheduleOptimizer(entry.value);
+            break;
+        case 'd':
+            m_distributionSpec = entry.value;
+            break;
+        case 'z':
+            m_sizeCorrelation = std::min(std::max(std::stod(entry.value), 0.0), 1.0);
+            break;
         default:
             if (m_rank == 0)
             {
@@ -103,13 +192,22 @@ void BenchmarkVariableMessage::parseArguments(std::vector<ArgumentEntry> args)
     }
 }
 
+/**
+ * @brief Pre-generate the fragment size of every event sent in a phase
+ *
+ * Without a distribution specification, the legacy behaviour is kept: a number of size
+ * variants is drawn uniformly and every event picks one of them with equal probability.
+ * The event seed is shared by all ranks so that per-event correlation across RUs holds.
+ */
 void BenchmarkVariableMessage::initMessageSizes()
 {
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937 generator(seed);
+    unsigned eventSeed = 0;
+    if (m_rank == 0)
+        eventSeed = std::chrono::system_clock::now().time_since_epoch().count();
+    MPI_Bcast(&eventSeed, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
 
-    std::size_t lowerBound = 1e4;
-    std::size_t upperBound = m_ruBufferBytes;
+    std::size_t lowerBound = minMessageSize;
+    std::size_t upperBound = std::min(m_ruBufferBytes, m_buBufferBytes);
 
     if (upperBound < lowerBound)
     {
@@ -118,13 +216,32 @@ void BenchmarkVariableMessage::initMessageSizes()
         std::exit(1);
     }
 
-    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    if (m_distributionSpec.empty())
+    {
+        std::mt19937 generator(eventSeed);
+        std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+        std::vector<std::size_t> variants;
+        for (size_t i = 0; i < m_messageSizeVariants; i++)
+        {
+            double randomValue = distribution(generator);
+            variants.push_back(std::round(randomValue * (upperBound - lowerBound) + lowerBound));
+        }
 
-    m_messageSizes.clear();
-    for (size_t i = 0; i < m_messageSizeVariants; i++)
+        m_sizeDistribution = std::make_unique<EmpiricalSizeDistribution>(variants, std::vector<double>(variants.size(), 1.0));
+    }
+    else
     {
-        double randomValue = distribution(generator);
-        std::size_t messageSize = std::round(randomValue * (upperBound - lowerBound) + lowerBound);
-        m_messageSizes.push_back(messageSize);
+        m_sizeDistribution = createMessageSizeDistribution(m_distributionSpec);
+        if (!m_sizeDistribution)
+        {
+            if (m_rank == 0)
+                std::cerr << "Invalid message size distribution: " << m_distributionSpec << std::endl;
+            MPI_Finalize();
+            std::exit(1);
+        }
     }
+
+    m_messageSizes = generateMessageSizeSequence(*m_sizeDistribution, m_iterations * m_messagesPerPhase,
+                                                 lowerBound, upperBound, eventSeed, eventSeed + 1 + m_rank, m_sizeCorrelation);
 }
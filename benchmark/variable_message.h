@@ -4,6 +4,7 @@
 #include <random>
 
 #include "continuous_benchmark.h"
+#include "../distribution/message_size_distribution.h"
 
 class BenchmarkVariableMessage : public ContinuousBenchmark
 {
@@ -16,6 +17,10 @@ private:
     void parseArguments(std::vector<ArgumentEntry> args) override;
 
     std::size_t m_messageSizeVariants = 100;
+
+    std::string m_distributionSpec;  // empty: uniformly drawn size variants
+    double m_sizeCorrelation = 0.0; // per-event size correlation across RUs
+    std::unique_ptr<MessageSizeDistribution> m_sizeDistribution;
 };
 
 #endif // BENCHMARKVARIABLEMESSAGE_H
@@ -65,7 +65,12 @@ std::pair<std::size_t, std::size_t> CommunicationInterface::blockingCommunicatio
             if (sendOffset + messageSize > sndBufferBytes)
                 sendOffset = 0;
 
-            MPI_Send(bufferSnd + sendOffset, messageSize, MPI_BYTE, buRank, 0, MPI_COMM_WORLD);
+            if (m_traceWriter)
+                m_traceWriter->record(messageSize);
+            if (m_oneWayLatencies)
+                stampSendTime(bufferSnd + sendOffset);
+
+            MPI_Send(bufferSnd + sendOffset, messageSize, MPI_BYTE, buRank, 0, m_comm);
 
             sendOffset = (sendOffset + messageSize) % sndBufferBytes;
         }
@@ -81,7 +86,9 @@ std::pair<std::size_t, std::size_t> CommunicationInterface::blockingCommunicatio
             if (recvOffset + messageSize > rcvBufferBytes)
                 recvOffset = 0;
 
-            MPI_Recv(bufferRcv + recvOffset, messageSize, MPI_BYTE, ruRank, 0, MPI_COMM_WORLD, &statuses[i]);
+            MPI_Recv(bufferRcv + recvOffset, messageSize, MPI_BYTE, receiveSource(ruRank), 0, m_comm, &statuses[i]);
+            if (m_oneWayLatencies)
+                collectOneWayLatency(bufferRcv + recvOffset);
 
             recvOffset = (recvOffset + messageSize) % rcvBufferBytes;
         }
@@ -96,66 +103,197 @@ std::pair<std::size_t, std::size_t> CommunicationInterface::blockingCommunicatio
     return std::make_pair(errorMessageCount, transferredSize);
 }
 
-std::pair<std::size_t, std::size_t> CommunicationInterface::nonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
-                                                                                     std::size_t messageSize, std::size_t iterations)
+/**
+ * @brief Hand fragments to a BU on the same node without copying them
+ *
+ * The RU's fragments live in its segment of an MPI_Win_allocate_shared window, which the BU
+ * maps as well. The RU sends the BU the offset of every fragment of the batch and waits for
+ * the acknowledgement of the fragments the BU accepted, after which it may reuse their space.
+ * Fragments are neither copied nor read, so the throughput is the rate of hand-overs and
+ * not a memory bandwidth; MPI_Win_sync orders the RU's writes before the BU's reads.
+ *
+ * @param segment RU's segment, queried by the caller with MPI_Win_shared_query
+ * @param segmentBytes
+ * @param window Window of the segment, locked with MPI_Win_lock_all
+ */
+std::pair<std::size_t, std::size_t> CommunicationInterface::sharedMemoryCommunication(int ruRank, int buRank, int processRank,
+                                                                                      int8_t *segment, std::size_t segmentBytes, MPI_Win window,
+                                                                                      std::size_t messageSize, std::size_t iterations)
 {
-    std::vector<MPI_Request> sendRequests(iterations);
-    std::vector<MPI_Request> recvRequests(iterations);
-    std::vector<MPI_Status> statuses(iterations);
+    std::vector<uint64_t> offsets(iterations);
+    uint64_t handedOver = 0;
 
-    std::size_t errorMessageCount = 0;
-    std::size_t transferredSize = messageSize * iterations;
+    if (processRank == ruRank)
+    {
+        std::size_t segmentOffset = 0;
 
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            if (segmentOffset + messageSize > segmentBytes)
+                segmentOffset = 0;
+
+            if (m_traceWriter)
+                m_traceWriter->record(messageSize);
+
+            offsets[i] = segmentOffset;
+            segmentOffset = (segmentOffset + messageSize) % segmentBytes;
+        }
+
+        MPI_Win_sync(window);
+        MPI_Send(offsets.data(), iterations, MPI_UINT64_T, buRank, m_handoffTag, m_comm);
+        MPI_Recv(&handedOver, 1, MPI_UINT64_T, buRank, m_handoffTag, m_comm, MPI_STATUS_IGNORE);
+    }
+    else if (processRank == buRank)
+    {
+        MPI_Recv(offsets.data(), iterations, MPI_UINT64_T, receiveSource(ruRank), m_handoffTag, m_comm, MPI_STATUS_IGNORE);
+        MPI_Win_sync(window);
+
+        // segment + offset is the fragment, a builder would read it in place
+        handedOver = std::count_if(offsets.begin(), offsets.end(), [&](uint64_t offset)
+                                   { return offset + messageSize <= segmentBytes; });
+
+        MPI_Send(&handedOver, 1, MPI_UINT64_T, ruRank, m_handoffTag, m_comm);
+    }
+
+    return std::make_pair(iterations - handedOver, messageSize * handedOver);
+}
+
+/**
+ * @brief Write the global send time into the first bytes of an outgoing fragment
+ */
+void CommunicationInterface::stampSendTime(int8_t *message)
+{
+    double sendTime = ClockSync::now();
+    std::memcpy(message, &sendTime, sizeof(sendTime));
+}
+
+/**
+ * @brief Read the send time stamped by the RU and record the fragment's one-way latency
+ */
+void CommunicationInterface::collectOneWayLatency(const int8_t *message)
+{
+    double arrivalTime = ClockSync::now();
+    double sendTime;
+    std::memcpy(&sendTime, message, sizeof(sendTime));
+    m_oneWayLatencies->push_back(arrivalTime - sendTime);
+}
+
+std::pair<std::size_t, std::size_t> CommunicationInterface::nonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                     std::size_t messageSize, std::size_t iterations)
+{
     if (processRank == ruRank)
     {
         int8_t *bufferSnd = unit->getBuffer();
         std::size_t sndBufferBytes = unit->getBufferBytes();
         std::size_t sendOffset = 0;
 
-        for (std::size_t i = 0; i < iterations; i++)
+        auto post = [&](std::size_t, MPI_Request &request)
         {
             if (sendOffset + messageSize > sndBufferBytes)
                 sendOffset = 0;
 
-            MPI_Isend(bufferSnd + sendOffset, messageSize, MPI_BYTE, buRank, 0, MPI_COMM_WORLD, &sendRequests[i]);
+            if (m_traceWriter)
+                m_traceWriter->record(messageSize);
+
+            MPI_Isend(bufferSnd + sendOffset, messageSize, MPI_BYTE, buRank, 0, m_comm, &request);
 
             sendOffset = (sendOffset + messageSize) % sndBufferBytes;
-        }
+            return messageSize;
+        };
+
+        StreamEngine engine;
+        StreamResult result;
+        windowedStream(engine, iterations, iterations, post, result);
+        engine.run();
+
+        return std::make_pair(result.errors, result.transferredSize);
     }
     else if (processRank == buRank)
     {
-        int8_t *bufferRcv = unit->getBuffer();
-        std::size_t rcvBufferBytes = unit->getBufferBytes();
-        std::size_t recvOffset = 0;
+        std::vector<MPI_Request> recvRequests;
+        postReceives(unit, ruRank, messageSize, iterations, 0, unit->getBufferBytes(), m_comm, recvRequests);
+        return completeReceives(recvRequests, messageSize);
+    }
 
-        for (std::size_t i = 0; i < iterations; i++)
-        {
-            if (recvOffset + messageSize > rcvBufferBytes)
-                recvOffset = 0;
+    return std::make_pair(0, 0);
+}
 
-            MPI_Irecv(bufferRcv + recvOffset, messageSize, MPI_BYTE, ruRank, 0, MPI_COMM_WORLD, &recvRequests[i]);
+/**
+ * @brief Post non-blocking receives for one batch into a region of the unit buffer
+ *
+ * @param unit
+ * @param ruRank Sender
+ * @param messageSize
+ * @param iterations Number of receives
+ * @param bufferOffset Start of the region used by this batch
+ * @param bufferBytes Size of the region, messages wrap around inside it
+ * @param comm Communicator the sender uses, ruRank is relative to it
+ * @param requests Filled with one request per receive
+ */
+void CommunicationInterface::postReceives(Unit *unit, int ruRank, std::size_t messageSize, std::size_t iterations,
+                                          std::size_t bufferOffset, std::size_t bufferBytes, MPI_Comm comm, std::vector<MPI_Request> &requests)
+{
+    int8_t *bufferRcv = unit->getBuffer() + bufferOffset;
+    std::size_t recvOffset = 0;
 
-            recvOffset = (recvOffset + messageSize) % rcvBufferBytes;
-        }
+    requests.resize(iterations);
+
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        if (recvOffset + messageSize > bufferBytes)
+            recvOffset = 0;
+
+        MPI_Irecv(bufferRcv + recvOffset, messageSize, MPI_BYTE, receiveSource(ruRank), 0, comm, &requests[i]);
+
+        recvOffset = (recvOffset + messageSize) % bufferBytes;
     }
+}
 
-    if (processRank == ruRank)
-        MPI_Waitall(iterations, sendRequests.data(), statuses.data());
+/**
+ * @brief Wait for a batch posted with postReceives()
+ *
+ * Timestamps the first and the last completion of the batch (see getFirstCompletionTime()
+ * and getLastCompletionTime()), which is what phase-switch gaps are measured from.
+ */
+std::pair<std::size_t, std::size_t> CommunicationInterface::completeReceives(std::vector<MPI_Request> &requests, std::size_t messageSize)
+{
+    StreamEngine engine;
+    StreamResult result;
+    receiveStream(engine, requests, messageSize, result);
+    engine.run();
 
-    if (processRank == buRank)
-        MPI_Waitall(iterations, recvRequests.data(), statuses.data());
+    return std::make_pair(result.errors, result.transferredSize);
+}
 
-    errorMessageCount = std::count_if(statuses.begin(), statuses.end(),
-                                      [](const MPI_Status &status)
-                                      { return status.MPI_ERROR != MPI_SUCCESS; });
+/**
+ * @brief Stream over receives that are already posted, awaited in posting order
+ *
+ * Messages match the receives in posting order, so the first one awaited is the first
+ * of the batch to complete.
+ */
+StreamEngine::Stream CommunicationInterface::receiveStream(StreamEngine &engine, std::vector<MPI_Request> &requests, std::size_t messageSize,
+                                                           StreamResult &result)
+{
+    for (std::size_t i = 0; i < requests.size(); i++)
+    {
+        MPI_Status status = co_await engine.complete(requests[i]);
+        requests[i] = MPI_REQUEST_NULL; // freed by the engine's MPI_Testsome
 
-    transferredSize -= messageSize * errorMessageCount;
+        if (i == 0)
+            m_firstCompletionTime = CycleTimer::now();
 
-    return std::make_pair(errorMessageCount, transferredSize);
+        if (status.MPI_ERROR == MPI_SUCCESS)
+            result.transferredSize += messageSize;
+        else
+            result.errors++;
+    }
+
+    m_lastCompletionTime = CycleTimer::now();
 }
 
 std::pair<std::size_t, std::size_t> CommunicationInterface::variableBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
-                                                                                          std::vector<std::size_t> messageSizes, std::size_t iterations)
+                                                                                          const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                                          std::size_t firstEvent)
 {
     std::vector<MPI_Status> statuses(iterations);
 
@@ -168,20 +306,20 @@ std::pair<std::size_t, std::size_t> CommunicationInterface::variableBlockingComm
         std::size_t sendOffset = 0;
 
         int sndMessageSize;
-        std::random_device rd;
-        std::mt19937 generator(rd());
-        std::uniform_int_distribution<std::size_t> sizeDistribution(0, messageSizes.size() - 1);
 
         for (std::size_t i = 0; i < iterations; i++)
         {
-            sndMessageSize = static_cast<int>(messageSizes[sizeDistribution(generator)]);
+            sndMessageSize = static_cast<int>(messageSizes[(firstEvent + i) % messageSizes.size()]);
 
-            MPI_Send(&sndMessageSize, 1, MPI_INT, buRank, 0, MPI_COMM_WORLD); // Communicate message size over network
+            MPI_Send(&sndMessageSize, 1, MPI_INT, buRank, 0, m_comm); // Communicate message size over network
 
             if (sendOffset + sndMessageSize > sndBufferBytes)
                 sendOffset = 0;
 
-            MPI_Send(bufferSnd + sendOffset, sndMessageSize, MPI_BYTE, buRank, 0, MPI_COMM_WORLD);
+            if (m_traceWriter)
+                m_traceWriter->record(sndMessageSize);
+
+            MPI_Send(bufferSnd + sendOffset, sndMessageSize, MPI_BYTE, buRank, 0, m_comm);
 
             sendOffset = (sendOffset + sndMessageSize) % sndBufferBytes;
         }
@@ -191,16 +329,16 @@ std::pair<std::size_t, std::size_t> CommunicationInterface::variableBlockingComm
         int8_t *bufferRcv = unit->getBuffer();
         const std::size_t rcvBufferBytes = unit->getBufferBytes();
         std::size_t recvOffset = 0;
-        std::size_t rcvMessageSize;
+        int rcvMessageSize;
 
         for (std::size_t i = 0; i < iterations; i++)
         {
-            MPI_Recv(&rcvMessageSize, 1, MPI_INT, ruRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE); // Receive the messageSize from rank 0
+            MPI_Recv(&rcvMessageSize, 1, MPI_INT, receiveSource(ruRank), 0, m_comm, MPI_STATUS_IGNORE); // Receive the messageSize from rank 0
 
             if (recvOffset + rcvMessageSize > rcvBufferBytes)
                 recvOffset = 0;
 
-            MPI_Recv(bufferRcv + recvOffset, rcvMessageSize, MPI_BYTE, ruRank, 0, MPI_COMM_WORLD, &statuses[i]);
+            MPI_Recv(bufferRcv + recvOffset, rcvMessageSize, MPI_BYTE, receiveSource(ruRank), 0, m_comm, &statuses[i]);
 
             recvOffset = (recvOffset + rcvMessageSize) % rcvBufferBytes;
 
@@ -217,38 +355,100 @@ std::pair<std::size_t, std::size_t> CommunicationInterface::variableBlockingComm
 }
 
 std::pair<std::size_t, std::size_t> CommunicationInterface::variableNonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
-                                                                                             std::vector<std::size_t> messageSizes, std::size_t iterations)
+                                                                                             const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                                             std::size_t firstEvent)
+{
+    // every fragment's size is sent ahead of it, the fragments themselves overlap
+    if (processRank != ruRank && processRank != buRank)
+        return std::make_pair(0, 0);
+
+    int8_t *buffer = unit->getBuffer();
+    const std::size_t bufferBytes = unit->getBufferBytes();
+    std::size_t offset = 0;
+
+    auto post = [&](std::size_t i, MPI_Request &request) -> std::size_t
+    {
+        int messageSize;
+        if (processRank == ruRank)
+        {
+            messageSize = static_cast<int>(messageSizes[(firstEvent + i) % messageSizes.size()]);
+            MPI_Send(&messageSize, 1, MPI_INT, buRank, 0, m_comm);
+        }
+        else
+        {
+            MPI_Recv(&messageSize, 1, MPI_INT, receiveSource(ruRank), 0, m_comm, MPI_STATUS_IGNORE);
+        }
+
+        if (offset + messageSize > bufferBytes)
+            offset = 0;
+
+        if (processRank == ruRank)
+        {
+            if (m_traceWriter)
+                m_traceWriter->record(messageSize);
+            MPI_Isend(buffer + offset, messageSize, MPI_BYTE, buRank, 0, m_comm, &request);
+        }
+        else
+        {
+            MPI_Irecv(buffer + offset, messageSize, MPI_BYTE, receiveSource(ruRank), 0, m_comm, &request);
+        }
+
+        offset = (offset + messageSize) % bufferBytes;
+        return messageSize;
+    };
+
+    StreamEngine engine;
+    StreamResult result;
+    windowedStream(engine, iterations, iterations, post, result);
+    engine.run();
+
+    return std::make_pair(result.errors, result.transferredSize);
+}
+
+/**
+ * @brief Replay fragment sizes and inter-arrival times from a trace
+ *
+ * The RU sends each fragment no earlier than its recorded arrival time, measured from
+ * the start of the call. When the RU falls behind the trace it sends back-to-back.
+ * Sizes are communicated to the BU the same way as in variable mode.
+ *
+ * @param trace The RU's trace, only read on the RU and nullptr on the BU
+ */
+std::pair<std::size_t, std::size_t> CommunicationInterface::traceReplayCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                     TraceReader *trace, std::size_t maxMessageSize, std::size_t iterations)
 {
-    std::vector<MPI_Request> sendRequests(iterations);
-    std::vector<MPI_Request> recvRequests(iterations);
     std::vector<MPI_Status> statuses(iterations);
 
-    std::size_t errorMessageCount = 0;
     std::size_t transferredSize = 0;
 
     if (processRank == ruRank)
     {
         int8_t *bufferSnd = unit->getBuffer();
-        std::size_t sndBufferBytes = unit->getBufferBytes();
+        const std::size_t sndBufferBytes = unit->getBufferBytes();
         std::size_t sendOffset = 0;
 
         int sndMessageSize;
-        std::random_device rd;
-        std::mt19937 generator(rd());
-        std::uniform_int_distribution<std::size_t> sizeDistribution(0, messageSizes.size() - 1);
+        uint64_t scheduledNs = 0, elapsedNs = 0;
+        uint64_t startTime = CycleTimer::now();
 
         for (std::size_t i = 0; i < iterations; i++)
         {
-            // Communicate message size over network
-            sndMessageSize = static_cast<int>(messageSizes[sizeDistribution(generator)]);
+            TraceRecord record = trace->next();
+            sndMessageSize = static_cast<int>(std::min<std::size_t>(std::max<uint32_t>(record.size, 1), maxMessageSize));
+            scheduledNs += record.interArrivalNs;
+
+            while (elapsedNs < scheduledNs)
+                elapsedNs = CycleTimer::toSeconds(CycleTimer::now() - startTime) * 1e9;
 
-            MPI_Send(&sndMessageSize, 1, MPI_INT, buRank, 0, MPI_COMM_WORLD);
+            MPI_Send(&sndMessageSize, 1, MPI_INT, buRank, 0, m_comm);
 
-            // Send message from appropriate place in buffer
             if (sendOffset + sndMessageSize > sndBufferBytes)
                 sendOffset = 0;
 
-            MPI_Isend(bufferSnd + sendOffset, sndMessageSize, MPI_BYTE, buRank, 0, MPI_COMM_WORLD, &sendRequests[i]);
+            if (m_traceWriter)
+                m_traceWriter->record(sndMessageSize);
+
+            MPI_Send(bufferSnd + sendOffset, sndMessageSize, MPI_BYTE, buRank, 0, m_comm);
 
             sendOffset = (sendOffset + sndMessageSize) % sndBufferBytes;
         }
@@ -256,18 +456,18 @@ std::pair<std::size_t, std::size_t> CommunicationInterface::variableNonBlockingC
     else if (processRank == buRank)
     {
         int8_t *bufferRcv = unit->getBuffer();
-        std::size_t rcvBufferBytes = unit->getBufferBytes();
+        const std::size_t rcvBufferBytes = unit->getBufferBytes();
         std::size_t recvOffset = 0;
-        std::size_t rcvMessageSize;
+        int rcvMessageSize;
 
         for (std::size_t i = 0; i < iterations; i++)
         {
-            MPI_Recv(&rcvMessageSize, 1, MPI_INT, ruRank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE); // Receive the messageSize from rank 0
+            MPI_Recv(&rcvMessageSize, 1, MPI_INT, receiveSource(ruRank), 0, m_comm, MPI_STATUS_IGNORE);
 
             if (recvOffset + rcvMessageSize > rcvBufferBytes)
                 recvOffset = 0;
 
-            MPI_Irecv(bufferRcv + recvOffset, rcvMessageSize, MPI_BYTE, ruRank, 0, MPI_COMM_WORLD, &recvRequests[i]);
+            MPI_Recv(bufferRcv + recvOffset, rcvMessageSize, MPI_BYTE, receiveSource(ruRank), 0, m_comm, &statuses[i]);
 
             recvOffset = (recvOffset + rcvMessageSize) % rcvBufferBytes;
 
@@ -276,15 +476,509 @@ std::pair<std::size_t, std::size_t> CommunicationInterface::variableNonBlockingC
         }
     }
 
+    std::size_t errorMessageCount = std::count_if(statuses.begin(), statuses.end(),
+                                                  [](const MPI_Status &status)
+                                                  { return status.MPI_ERROR != MPI_SUCCESS; });
+
+    return std::make_pair(errorMessageCount, transferredSize);
+}
+
+/**
+ * @brief Open-loop communication at a fixed event rate
+ *
+ * Fragment k of the phase is due at phaseStart + k / eventRate, regardless of how fast earlier
+ * fragments completed. An RU that falls behind sends back-to-back until it catches up, missed
+ * slots are not dropped. The BU appends one latency per fragment (seconds): receive completion
+ * minus the fragment's due time. Both sides measure on phaseClock() against the same phaseStart,
+ * which is exact with synchronised clocks and otherwise off by the barrier exit skew.
+ *
+ * @param phaseStart Start of the phase on phaseClock(), shared by all batches and trials
+ * @param firstFragment Index of the batch's first fragment within the phase
+ */
+std::pair<std::size_t, std::size_t> CommunicationInterface::pacedCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                               std::size_t messageSize, std::size_t iterations,
+                                                                               double eventRate, double phaseStart, std::size_t firstFragment,
+                                                                               std::vector<double> &latencies)
+{
+    std::vector<MPI_Status> statuses(iterations);
+
+    std::size_t errorMessageCount = 0;
+    std::size_t transferredSize = messageSize * iterations;
+
+    const double interval = 1.0 / eventRate;
+
     if (processRank == ruRank)
-        MPI_Waitall(iterations, sendRequests.data(), statuses.data());
+    {
+        int8_t *bufferSnd = unit->getBuffer();
+        const std::size_t sndBufferBytes = unit->getBufferBytes();
+        std::size_t sendOffset = 0;
 
-    if (processRank == buRank)
-        MPI_Waitall(iterations, recvRequests.data(), statuses.data());
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            double due = phaseStart + (firstFragment + i) * interval;
+            while (phaseClock() < due)
+                ;
+
+            if (sendOffset + messageSize > sndBufferBytes)
+                sendOffset = 0;
+
+            if (m_traceWriter)
+                m_traceWriter->record(messageSize);
+            if (m_oneWayLatencies)
+                stampSendTime(bufferSnd + sendOffset);
+
+            MPI_Send(bufferSnd + sendOffset, messageSize, MPI_BYTE, buRank, 0, m_comm);
+
+            sendOffset = (sendOffset + messageSize) % sndBufferBytes;
+        }
+    }
+    else if (processRank == buRank)
+    {
+        int8_t *bufferRcv = unit->getBuffer();
+        const std::size_t rcvBufferBytes = unit->getBufferBytes();
+        std::size_t recvOffset = 0;
+
+        latencies.reserve(latencies.size() + iterations);
+
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            if (recvOffset + messageSize > rcvBufferBytes)
+                recvOffset = 0;
+
+            MPI_Recv(bufferRcv + recvOffset, messageSize, MPI_BYTE, receiveSource(ruRank), 0, m_comm, &statuses[i]);
+            double completion = phaseClock();
+            if (m_oneWayLatencies)
+                collectOneWayLatency(bufferRcv + recvOffset);
+
+            latencies.push_back(completion - (phaseStart + (firstFragment + i) * interval));
+
+            recvOffset = (recvOffset + messageSize) % rcvBufferBytes;
+        }
+    }
 
     errorMessageCount = std::count_if(statuses.begin(), statuses.end(),
                                       [](const MPI_Status &status)
                                       { return status.MPI_ERROR != MPI_SUCCESS; });
 
+    transferredSize -= messageSize * errorMessageCount;
+
+    return std::make_pair(errorMessageCount, transferredSize);
+}
+
+/**
+ * @brief Several RUs sending to one BU at the same time
+ *
+ * Each RU in ruRanks sends iterations fragments with blocking sends. The BU splits its buffer
+ * into one slice per sender and keeps a window of receives posted for every sender, polling
+ * the oldest one of each in turn so that completions are timestamped as they happen.
+ * The BU fills senderStatistics with one entry per sender. With clock synchronisation (-y)
+ * the RUs stamp the send time into every fragment and a fragment's latency is its one-way
+ * latency. Without, it is the fragment's service time, from its sender's previous completion
+ * (or the common start) to its own, as receive windows would otherwise hide the queueing.
+ */
+std::pair<std::size_t, std::size_t> CommunicationInterface::incastCommunication(Unit *unit, const std::vector<int> &ruRanks, int buRank, int processRank,
+                                                                                std::size_t messageSize, std::size_t iterations,
+                                                                                std::vector<SenderStatistics> &senderStatistics)
+{
+    std::size_t errorMessageCount = 0;
+    std::size_t transferredSize = 0;
+
+    if (processRank == buRank)
+    {
+        const std::size_t senders = ruRanks.size();
+        const std::size_t window = std::min(m_receiveWindow, iterations);
+        const std::size_t sliceBytes = unit->getBufferBytes() / senders;
+
+        std::vector<MPI_Request> requests(senders * window, MPI_REQUEST_NULL);
+        std::vector<std::size_t> posted(senders, 0), completed(senders, 0), recvOffsets(senders, 0);
+        std::vector<uint64_t> lastCompletion(senders);
+        std::vector<int8_t *> fragments(senders * window); // receive address of every window slot
+        const bool oneWay = stampsSendTime(messageSize);
+
+        senderStatistics.assign(senders, SenderStatistics());
+
+        auto post = [&](std::size_t sender)
+        {
+            if (recvOffsets[sender] + messageSize > sliceBytes)
+                recvOffsets[sender] = 0;
+
+            int8_t *fragment = unit->getBuffer() + sender * sliceBytes + recvOffsets[sender];
+            fragments[sender * window + posted[sender] % window] = fragment;
+            MPI_Irecv(fragment, messageSize, MPI_BYTE, ruRanks[sender], 0, MPI_COMM_WORLD,
+                      &requests[sender * window + posted[sender] % window]);
+
+            recvOffsets[sender] = (recvOffsets[sender] + messageSize) % sliceBytes;
+            posted[sender]++;
+        };
+
+        uint64_t startTime = CycleTimer::now();
+
+        for (std::size_t sender = 0; sender < senders; sender++)
+        {
+            senderStatistics[sender].rank = ruRanks[sender];
+            senderStatistics[sender].latencies.reserve(iterations);
+            lastCompletion[sender] = startTime;
+
+            while (posted[sender] < window)
+                post(sender);
+        }
+
+        std::size_t remaining = senders * iterations;
+        while (remaining > 0)
+        {
+            for (std::size_t sender = 0; sender < senders; sender++)
+            {
+                if (completed[sender] == iterations)
+                    continue;
+
+                int flag = 0;
+                int error = MPI_Test(&requests[sender * window + completed[sender] % window], &flag, MPI_STATUS_IGNORE);
+                if (!flag)
+                    continue;
+
+                uint64_t now = CycleTimer::now();
+                SenderStatistics &stats = senderStatistics[sender];
+
+                if (oneWay)
+                {
+                    double sendTime;
+                    std::memcpy(&sendTime, fragments[sender * window + completed[sender] % window], sizeof(sendTime));
+                    stats.latencies.push_back(ClockSync::now() - sendTime);
+                }
+                else
+                {
+                    stats.latencies.push_back(CycleTimer::toSeconds(now - lastCompletion[sender]));
+                }
+                lastCompletion[sender] = now;
+
+                if (error == MPI_SUCCESS)
+                    stats.transferredSize += messageSize;
+                else
+                    stats.errors++;
+
+                completed[sender]++;
+                remaining--;
+
+                if (posted[sender] < iterations)
+                    post(sender);
+            }
+        }
+
+        for (std::size_t sender = 0; sender < senders; sender++)
+        {
+            senderStatistics[sender].elapsedTime = CycleTimer::toSeconds(lastCompletion[sender] - startTime);
+
+            errorMessageCount += senderStatistics[sender].errors;
+            transferredSize += senderStatistics[sender].transferredSize;
+        }
+    }
+    else if (std::find(ruRanks.begin(), ruRanks.end(), processRank) != ruRanks.end())
+    {
+        int8_t *bufferSnd = unit->getBuffer();
+        const std::size_t sndBufferBytes = unit->getBufferBytes();
+        std::size_t sendOffset = 0;
+        const bool oneWay = stampsSendTime(messageSize);
+
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            if (sendOffset + messageSize > sndBufferBytes)
+                sendOffset = 0;
+
+            if (m_traceWriter)
+                m_traceWriter->record(messageSize);
+
+            if (oneWay)
+                stampSendTime(bufferSnd + sendOffset);
+
+            MPI_Send(bufferSnd + sendOffset, messageSize, MPI_BYTE, buRank, 0, MPI_COMM_WORLD);
+
+            sendOffset = (sendOffset + messageSize) % sndBufferBytes;
+        }
+    }
+
+    return std::make_pair(errorMessageCount, transferredSize);
+}
+
+/**
+ * @brief Non-blocking communication with several peers at once
+ *
+ * An RU sends iterations fragments to every BU in peerRanks, a BU receives iterations fragments
+ * from every RU in peerRanks. Every peer is a stream of its own with m_receiveWindow fragments
+ * outstanding, all driven by one StreamEngine, so no single peer's stall holds back the others.
+ * The streams post their first windows one peer after the other, then each peer's next fragment
+ * as one of its own completes. The BU splits its buffer into one slice per peer.
+ */
+std::pair<std::size_t, std::size_t> CommunicationInterface::fanOutCommunication(Unit *unit, const std::vector<int> &peerRanks,
+                                                                                std::size_t messageSize, std::size_t iterations)
+{
+    // one stream per peer, each with its own window, so a stalled peer only stalls its stream
+    const std::size_t peers = peerRanks.size();
+    const bool isRu = unit->getUnitType() == UnitType::RU;
+    if (!isRu && unit->getUnitType() != UnitType::BU)
+        return std::make_pair(0, 0);
+
+    int8_t *buffer = unit->getBuffer();
+    const std::size_t regionBytes = isRu ? unit->getBufferBytes() : unit->getBufferBytes() / peers;
+
+    StreamEngine engine;
+    std::vector<StreamResult> results(peers);
+
+    for (std::size_t peer = 0; peer < peers; peer++)
+    {
+        int8_t *region = isRu ? buffer : buffer + peer * regionBytes;
+
+        auto post = [&, region, peer, offset = std::size_t(0)](std::size_t, MPI_Request &request) mutable
+        {
+            if (offset + messageSize > regionBytes)
+                offset = 0;
+
+            if (isRu)
+            {
+                if (m_traceWriter)
+                    m_traceWriter->record(messageSize);
+                MPI_Isend(region + offset, messageSize, MPI_BYTE, peerRanks[peer], 0, MPI_COMM_WORLD, &request);
+            }
+            else
+            {
+                MPI_Irecv(region + offset, messageSize, MPI_BYTE, peerRanks[peer], 0, MPI_COMM_WORLD, &request);
+            }
+
+            offset = (offset + messageSize) % regionBytes;
+            return messageSize;
+        };
+
+        windowedStream(engine, iterations, m_receiveWindow, post, results[peer]);
+    }
+
+    engine.run();
+
+    if (isRu)
+        return std::make_pair(0, 0);
+
+    std::size_t errorMessageCount = 0;
+    std::size_t transferredSize = 0;
+    for (const StreamResult &result : results)
+    {
+        errorMessageCount += result.errors;
+        transferredSize += result.transferredSize;
+    }
+
+    return std::make_pair(errorMessageCount, transferredSize);
+}
+
+/**
+ * @brief Non-blocking communication with every fragment striped over several communicators
+ *
+ * Fragments are cut into stripes of stripeSize bytes, stripe s travels on rails[s % rails].
+ * Each rail is a duplicate of MPI_COMM_WORLD, so stripes of different rails never share a
+ * matching queue; whether they also take different HCAs is up to the transport configuration
+ * (e.g. UCX_NET_DEVICES listing both devices). railStatistics gets one entry per rail.
+ */
+std::pair<std::size_t, std::size_t> CommunicationInterface::stripedCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                 std::size_t messageSize, std::size_t iterations,
+                                                                                 std::size_t stripeSize, const std::vector<MPI_Comm> &rails,
+                                                                                 std::vector<RailStatistics> &railStatistics)
+{
+    const std::size_t stripes = (messageSize + stripeSize - 1) / stripeSize;
+    const std::size_t requestCount = iterations * stripes;
+
+    std::vector<MPI_Request> requests(requestCount);
+    std::vector<MPI_Status> statuses(requestCount);
+    std::vector<int> indices(requestCount);
+
+    railStatistics.assign(rails.size(), RailStatistics());
+
+    if (processRank != ruRank && processRank != buRank)
+        return std::make_pair(0, 0);
+
+    int8_t *buffer = unit->getBuffer();
+    const std::size_t bufferBytes = unit->getBufferBytes();
+    std::size_t offset = 0;
+
+    auto stripeBytes = [&](std::size_t stripe)
+    { return std::min(stripeSize, messageSize - stripe * stripeSize); };
+
+    uint64_t startTime = CycleTimer::now();
+
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        if (offset + messageSize > bufferBytes)
+            offset = 0;
+
+        if (processRank == ruRank && m_traceWriter)
+            m_traceWriter->record(messageSize);
+
+        for (std::size_t stripe = 0; stripe < stripes; stripe++)
+        {
+            MPI_Comm rail = rails[stripe % rails.size()];
+
+            if (processRank == ruRank)
+                MPI_Isend(buffer + offset + stripe * stripeSize, stripeBytes(stripe), MPI_BYTE, buRank, 0, rail, &requests[i * stripes + stripe]);
+            else
+                MPI_Irecv(buffer + offset + stripe * stripeSize, stripeBytes(stripe), MPI_BYTE, ruRank, 0, rail, &requests[i * stripes + stripe]);
+        }
+
+        offset = (offset + messageSize) % bufferBytes;
+    }
+
+    std::size_t remaining = requestCount;
+    while (remaining > 0)
+    {
+        int completed;
+        MPI_Waitsome(requestCount, requests.data(), &completed, indices.data(), statuses.data());
+        if (completed == MPI_UNDEFINED)
+            break;
+
+        uint64_t now = CycleTimer::now();
+
+        for (int c = 0; c < completed; c++)
+        {
+            std::size_t stripe = indices[c] % stripes;
+            RailStatistics &stats = railStatistics[stripe % rails.size()];
+
+            if (statuses[c].MPI_ERROR == MPI_SUCCESS)
+                stats.transferredSize += stripeBytes(stripe);
+            else
+                stats.errors++;
+
+            stats.elapsedTime = CycleTimer::toSeconds(now - startTime);
+        }
+
+        remaining -= completed;
+    }
+
+    std::size_t errorMessageCount = 0;
+    std::size_t transferredSize = 0;
+    for (const RailStatistics &stats : railStatistics)
+    {
+        errorMessageCount += stats.errors;
+        transferredSize += stats.transferredSize;
+    }
+
+    return std::make_pair(errorMessageCount, transferredSize);
+}
+
+/**
+ * @brief Partitioned communication of fragments filled incrementally by a readout thread
+ *
+ * A producer thread writes each fragment into the RU buffer one partition at a time (paced to
+ * readoutRate Mbit/s, unpaced if 0) while the calling thread marks finished partitions ready,
+ * so the transfer may start before the whole fragment exists. Only the calling thread makes
+ * MPI calls. With MPI-4 this uses MPI_Psend_init/MPI_Precv_init/MPI_Pready, older libraries
+ * fall back to one persistent request per partition started as the partition is ready.
+ */
+std::pair<std::size_t, std::size_t> CommunicationInterface::partitionedCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                     std::size_t messageSize, std::size_t iterations,
+                                                                                     std::size_t partitions, double readoutRate)
+{
+    const std::size_t partitionBytes = messageSize / partitions;
+
+    std::size_t errorMessageCount = 0;
+    std::size_t transferredSize = 0;
+
+    if (processRank != ruRank && processRank != buRank)
+        return std::make_pair(0, 0);
+
+    int8_t *buffer = unit->getBuffer();
+
+#if MPI_VERSION >= 4
+    std::vector<MPI_Request> requests(1);
+    if (processRank == ruRank)
+        MPI_Psend_init(buffer, partitions, partitionBytes, MPI_BYTE, buRank, 0, m_comm, MPI_INFO_NULL, &requests[0]);
+    else
+        MPI_Precv_init(buffer, partitions, partitionBytes, MPI_BYTE, ruRank, 0, m_comm, MPI_INFO_NULL, &requests[0]);
+#else
+    std::vector<MPI_Request> requests(partitions);
+    for (std::size_t p = 0; p < partitions; p++)
+    {
+        if (processRank == ruRank)
+            MPI_Send_init(buffer + p * partitionBytes, partitionBytes, MPI_BYTE, buRank, 0, m_comm, &requests[p]);
+        else
+            MPI_Recv_init(buffer + p * partitionBytes, partitionBytes, MPI_BYTE, ruRank, 0, m_comm, &requests[p]);
+    }
+#endif
+
+    std::vector<MPI_Status> statuses(requests.size());
+
+    if (processRank == buRank)
+    {
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            MPI_Startall(requests.size(), requests.data());
+            MPI_Waitall(requests.size(), requests.data(), statuses.data());
+
+            std::size_t errors = std::count_if(statuses.begin(), statuses.end(),
+                                               [](const MPI_Status &status)
+                                               { return status.MPI_ERROR != MPI_SUCCESS; });
+            errorMessageCount += (errors > 0);
+            transferredSize += (errors > 0) ? 0 : messageSize;
+        }
+    }
+    else
+    {
+        // partitions produced so far, counted over all fragments of this call
+        std::atomic<std::size_t> requested(0), produced(0);
+
+        auto produce = [&]()
+        {
+            TokenBucket bucket((readoutRate > 0) ? readoutRate * 1e6 / 8 / partitionBytes : 1.0);
+            bucket.start();
+
+            for (std::size_t i = 0; i < iterations; i++)
+            {
+                while (requested.load(std::memory_order_acquire) <= i)
+                    std::this_thread::yield();
+
+                TimelineScope readoutScope("readout", i);
+
+                for (std::size_t p = 0; p < partitions; p++)
+                {
+                    if (readoutRate > 0)
+                        bucket.acquire();
+
+                    std::memset(buffer + p * partitionBytes, static_cast<int>(i), partitionBytes);
+                    produced.store(i * partitions + p + 1, std::memory_order_release);
+                }
+            }
+        };
+
+        std::thread readout(produce);
+
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            if (m_traceWriter)
+                m_traceWriter->record(messageSize);
+
+#if MPI_VERSION >= 4
+            MPI_Start(&requests[0]);
+#endif
+            requested.store(i + 1, std::memory_order_release);
+
+            std::size_t marked = 0;
+            while (marked < partitions)
+            {
+                std::size_t ready = produced.load(std::memory_order_acquire) - i * partitions;
+                if (ready == marked)
+                    std::this_thread::yield();
+
+                for (; marked < ready; marked++)
+                {
+#if MPI_VERSION >= 4
+                    MPI_Pready(marked, requests[0]);
+#else
+                    MPI_Start(&requests[marked]);
+#endif
+                }
+            }
+
+            MPI_Waitall(requests.size(), requests.data(), statuses.data());
+        }
+
+        readout.join();
+    }
+
+    for (MPI_Request &request : requests)
+        MPI_Request_free(&request);
+
     return std::make_pair(errorMessageCount, transferredSize);
 }
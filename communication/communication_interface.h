@@ -5,29 +5,132 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include <random>
+#include <atomic>
+#include <thread>
 
 #include "../unit/unit.h"
+#include "transport.h"
+#include "stream_engine.h"
+#include "../traffic/traffic_trace.h"
+#include "../traffic/token_bucket.h"
+#include "../timing/cycle_timer.h"
+#include "../timing/timeline.h"
+#include "../timing/clock_sync.h"
 
-class CommunicationInterface
+struct SenderStatistics
+{
+    int rank = -1;
+    std::size_t transferredSize = 0;
+    std::size_t errors = 0;
+    double elapsedTime = 0.0;           // s, until the sender's last fragment completed
+    std::vector<double> latencies;      // s, per fragment, one-way with -y, else service time (see incastCommunication())
+};
+
+struct RailStatistics
+{
+    std::size_t transferredSize = 0;
+    std::size_t errors = 0;  // stripes, not fragments
+    double elapsedTime = 0.0; // s, until the rail's last stripe completed
+};
+
+class CommunicationInterface : public Transport
 {
 public:
+    std::string describeTransport() const override { return "MPI"; }
+
     std::pair<std::size_t, std::size_t> twoRankBlockingCommunication(int8_t *bufferSnd, int8_t *bufferRcv,
                                                                      std::size_t sndBufferBytes, std::size_t rcvBufferBytes,
-                                                                     std::size_t messageSize, int rank, std::size_t iterations);
+                                                                     std::size_t messageSize, int rank, std::size_t iterations) override;
 
     std::pair<std::size_t, std::size_t> blockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
-                                                              std::size_t messageSize, std::size_t iterations);
+                                                              std::size_t messageSize, std::size_t iterations) override;
+
+    std::pair<std::size_t, std::size_t> stripedCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                             std::size_t messageSize, std::size_t iterations,
+                                                             std::size_t stripeSize, const std::vector<MPI_Comm> &rails,
+                                                             std::vector<RailStatistics> &railStatistics);
 
     std::pair<std::size_t, std::size_t> nonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
-                                                                 std::size_t messageSize, std::size_t iterations);
+                                                                 std::size_t messageSize, std::size_t iterations) override;
+
+    void postReceives(Unit *unit, int ruRank, std::size_t messageSize, std::size_t iterations,
+                      std::size_t bufferOffset, std::size_t bufferBytes, MPI_Comm comm, std::vector<MPI_Request> &requests);
+
+    std::pair<std::size_t, std::size_t> completeReceives(std::vector<MPI_Request> &requests, std::size_t messageSize);
+
+    uint64_t getFirstCompletionTime() const { return m_firstCompletionTime; }
+    uint64_t getLastCompletionTime() const { return m_lastCompletionTime; }
 
     std::pair<std::size_t, std::size_t> variableBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
-                                                                      std::vector<std::size_t> messageSizes, std::size_t iterations);
+                                                                      const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                      std::size_t firstEvent = 0) override;
 
     std::pair<std::size_t, std::size_t> variableNonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
-                                                                         std::vector<std::size_t> messageSizes, std::size_t iterations);
+                                                                         const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                         std::size_t firstEvent = 0) override;
+
+    std::pair<std::size_t, std::size_t> traceReplayCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                 TraceReader *trace, std::size_t maxMessageSize, std::size_t iterations);
+
+    std::pair<std::size_t, std::size_t> pacedCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                           std::size_t messageSize, std::size_t iterations,
+                                                           double eventRate, double phaseStart, std::size_t firstFragment,
+                                                           std::vector<double> &latencies);
+
+    /**
+     * @brief Seconds in rank 0's timebase when clocks are synchronised (-y), else on this rank's cycle timer
+     */
+    static double phaseClock() { return ClockSync::isEnabled() ? ClockSync::now() : CycleTimer::toSeconds(CycleTimer::now()); }
+
+    // incast: RUs stamp the send time into fragments that can hold it while clocks are synchronised
+    static bool stampsSendTime(std::size_t messageSize) { return ClockSync::isEnabled() && messageSize >= sizeof(double); }
+
+    std::pair<std::size_t, std::size_t> partitionedCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                 std::size_t messageSize, std::size_t iterations,
+                                                                 std::size_t partitions, double readoutRate);
+
+    std::pair<std::size_t, std::size_t> incastCommunication(Unit *unit, const std::vector<int> &ruRanks, int buRank, int processRank,
+                                                            std::size_t messageSize, std::size_t iterations,
+                                                            std::vector<SenderStatistics> &senderStatistics);
+
+    std::pair<std::size_t, std::size_t> sharedMemoryCommunication(int ruRank, int buRank, int processRank,
+                                                                  int8_t *segment, std::size_t segmentBytes, MPI_Win window,
+                                                                  std::size_t messageSize, std::size_t iterations);
+
+    std::pair<std::size_t, std::size_t> fanOutCommunication(Unit *unit, const std::vector<int> &peerRanks,
+                                                            std::size_t messageSize, std::size_t iterations);
+
+    void setTraceWriter(TraceWriter *writer) { m_traceWriter = writer; }
+    void setOneWayLatencies(std::vector<double> *latencies) { m_oneWayLatencies = latencies; }
+
+    void setCommunicator(MPI_Comm comm) { m_comm = comm; }
+    void setAnySource(bool anySource) { m_anySource = anySource; }
+
+protected:
+    int receiveSource(int ruRank) const { return m_anySource ? MPI_ANY_SOURCE : ruRank; }
+
+    MPI_Comm m_comm = MPI_COMM_WORLD; // of the single-pair modes, ranks passed to them are relative to it
+    bool m_anySource = false;         // single-pair modes receive with MPI_ANY_SOURCE (matching worst case)
+
+    void stampSendTime(int8_t *message);
+    void collectOneWayLatency(const int8_t *message);
+
+    StreamEngine::Stream receiveStream(StreamEngine &engine, std::vector<MPI_Request> &requests, std::size_t messageSize,
+                                       StreamResult &result);
+
+    TraceWriter *m_traceWriter = nullptr; // records every RU send when set
+
+    // blocking single-pair modes: RUs stamp ClockSync time into each fragment, BUs append arrival minus stamp (s)
+    std::vector<double> *m_oneWayLatencies = nullptr;
+
+    const std::size_t m_receiveWindow = 32; // outstanding receives per sender
+    const int m_handoffTag = 1;             // shared-memory mode: batch notifications and acknowledgements
+
+    uint64_t m_firstCompletionTime = 0; // CycleTimer ticks, of the last batch passed to completeReceives()
+    uint64_t m_lastCompletionTime = 0;
 };
 
 #endif // COMMUNICATIONINTERFACE_H
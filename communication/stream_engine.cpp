@@ -0,0 +1,60 @@
+#include "stream_engine.h"
+
+void StreamEngine::enqueue(MPI_Request request, std::coroutine_handle<> handle, MPI_Status *status)
+{
+    m_requests.push_back(request);
+    m_waiters.push_back(handle);
+    m_statuses.push_back(status);
+}
+
+/**
+ * @brief Resume streams as their requests complete until no stream is waiting
+ */
+void StreamEngine::run()
+{
+    std::vector<std::coroutine_handle<>> ready;
+
+    while (!m_requests.empty())
+    {
+        const int count = m_requests.size();
+        m_indices.resize(count);
+        m_completed.resize(count);
+        for (MPI_Status &status : m_completed)
+            status.MPI_ERROR = MPI_SUCCESS; // only filled in with MPI_ERR_IN_STATUS
+
+        int completed = 0;
+        int error = MPI_Testsome(count, m_requests.data(), &completed, m_indices.data(), m_completed.data());
+        if (completed == MPI_UNDEFINED || completed == 0)
+            continue;
+
+        for (int i = 0; i < completed; i++)
+        {
+            MPI_Status &status = m_completed[i];
+            if (error != MPI_SUCCESS && error != MPI_ERR_IN_STATUS)
+                status.MPI_ERROR = error;
+
+            *m_statuses[m_indices[i]] = status;
+            ready.push_back(m_waiters[m_indices[i]]);
+        }
+
+        // drop the completed entries (MPI_REQUEST_NULL now) before streams enqueue new ones
+        std::size_t kept = 0;
+        for (std::size_t slot = 0; slot < m_requests.size(); slot++)
+        {
+            if (m_requests[slot] == MPI_REQUEST_NULL)
+                continue;
+
+            m_requests[kept] = m_requests[slot];
+            m_waiters[kept] = m_waiters[slot];
+            m_statuses[kept] = m_statuses[slot];
+            kept++;
+        }
+        m_requests.resize(kept);
+        m_waiters.resize(kept);
+        m_statuses.resize(kept);
+
+        for (std::coroutine_handle<> handle : ready)
+            handle.resume();
+        ready.clear();
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef STREAMENGINE_H
+#define STREAMENGINE_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "The non-blocking modes run on C++20 coroutines, build with -std=c++20"
+#endif
+
+#include <mpi.h>
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+struct StreamResult
+{
+    std::size_t transferredSize = 0;
+    std::size_t errors = 0;
+};
+
+/**
+ * @brief Drives coroutines that await MPI requests, polling all of them with MPI_Testsome
+ *
+ * A stream is a coroutine returning StreamEngine::Stream. It starts running when called,
+ * posts its requests and suspends in co_await engine.complete(request) until that request
+ * is done; run() resumes streams as their requests complete until none is waiting. Any
+ * number of streams share one engine, so one rank can keep many peers busy without each
+ * one's progress depending on the slowest. Only the calling thread touches MPI.
+ */
+class StreamEngine
+{
+public:
+    struct Stream
+    {
+        // fire and forget, the frame frees itself when the stream returns
+        struct promise_type
+        {
+            Stream get_return_object() { return Stream(); }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    class RequestAwaiter
+    {
+    public:
+        RequestAwaiter(StreamEngine &engine, MPI_Request request) : m_engine(engine), m_request(request) {}
+
+        bool await_ready() const { return m_request == MPI_REQUEST_NULL; }
+        void await_suspend(std::coroutine_handle<> handle) { m_engine.enqueue(m_request, handle, &m_status); }
+        MPI_Status await_resume() const { return m_status; }
+
+    private:
+        StreamEngine &m_engine;
+        MPI_Request m_request;
+        MPI_Status m_status = {};
+    };
+
+    RequestAwaiter complete(MPI_Request request) { return RequestAwaiter(*this, request); }
+
+    void run();
+
+private:
+    void enqueue(MPI_Request request, std::coroutine_handle<> handle, MPI_Status *status);
+
+    std::vector<MPI_Request> m_requests; // pending, contiguous for MPI_Testsome
+    std::vector<std::coroutine_handle<>> m_waiters;
+    std::vector<MPI_Status *> m_statuses; // in the waiters' awaiters
+
+    std::vector<int> m_indices;
+    std::vector<MPI_Status> m_completed;
+};
+
+/**
+ * @brief Stream of count operations, at most window outstanding, completed in posting order
+ *
+ * @param post Called as post(i, request) to start operation i, returns its size in bytes
+ * @param result Bytes of the operations that succeeded and the count of those that failed
+ */
+template <typename Post>
+StreamEngine::Stream windowedStream(StreamEngine &engine, std::size_t count, std::size_t window, Post post, StreamResult &result)
+{
+    window = std::max<std::size_t>(1, std::min(window, count));
+    std::vector<MPI_Request> requests(window, MPI_REQUEST_NULL);
+    std::vector<std::size_t> bytes(window, 0);
+    std::size_t posted = 0;
+
+    for (std::size_t completed = 0; completed < count; completed++)
+    {
+        for (; posted < count && posted - completed < window; posted++)
+            bytes[posted % window] = post(posted, requests[posted % window]);
+
+        MPI_Status status = co_await engine.complete(requests[completed % window]);
+
+        if (status.MPI_ERROR == MPI_SUCCESS)
+            result.transferredSize += bytes[completed % window];
+        else
+            result.errors++;
+    }
+}
+
+#endif // STREAMENGINE_H
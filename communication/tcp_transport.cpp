@@ -0,0 +1,468 @@
+#include "tcp_transport.h"
+
+#include <arpa/inet.h>
+#include <linux/errqueue.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+#include "../unit/unit.h"
+
+TcpTransport::~TcpTransport()
+{
+    for (int fd : m_sockets)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+/**
+ * @brief Connect every RU to every BU (collective over comm)
+ *
+ * @return false if this rank could not listen, resolve or connect, the caller aborts
+ */
+bool TcpTransport::connect(MPI_Comm comm)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    const bool isRu = (rank % 2 == 0);
+
+    // every rank listens, only BUs accept, so the exchange stays symmetric
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int enable = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = 0;
+    socklen_t addressLength = sizeof(address);
+
+    bool ok = listener >= 0 &&
+              bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0 &&
+              listen(listener, size) == 0 &&
+              getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addressLength) == 0;
+
+    char hostname[HOST_NAME_MAX + 1] = {};
+    gethostname(hostname, HOST_NAME_MAX);
+    int port = ok ? ntohs(address.sin_port) : -1;
+
+    std::vector<char> hostnames(size * (HOST_NAME_MAX + 1));
+    std::vector<int> ports(size);
+    MPI_Allgather(hostname, HOST_NAME_MAX + 1, MPI_CHAR, hostnames.data(), HOST_NAME_MAX + 1, MPI_CHAR, comm);
+    MPI_Allgather(&port, 1, MPI_INT, ports.data(), 1, MPI_INT, comm);
+
+    m_sockets.assign(size, -1);
+    m_zeroCopySent.assign(size, 0);
+    m_zeroCopyDone.assign(size, 0);
+
+    if (isRu)
+    {
+        for (int peer = 1; peer < size && ok; peer += 2)
+        {
+            const char *peerHost = &hostnames[peer * (HOST_NAME_MAX + 1)];
+
+            addrinfo hints = {};
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo *result = nullptr;
+            if (ports[peer] < 0 || getaddrinfo(peerHost, std::to_string(ports[peer]).c_str(), &hints, &result) != 0)
+            {
+                std::cerr << "Rank " << rank << ": cannot resolve " << peerHost << std::endl;
+                ok = false;
+                break;
+            }
+
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            ok = fd >= 0 && ::connect(fd, result->ai_addr, result->ai_addrlen) == 0;
+            freeaddrinfo(result);
+            if (!ok)
+            {
+                std::cerr << "Rank " << rank << ": cannot connect to " << peerHost << ":" << ports[peer]
+                          << " (" << std::strerror(errno) << ")" << std::endl;
+                break;
+            }
+
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+            if (m_zeroCopy && setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) != 0)
+                m_zeroCopy = false; // kernel before 4.14
+
+            int32_t self = rank;
+            ok = send(fd, &self, sizeof(self), MSG_NOSIGNAL) == sizeof(self);
+            m_sockets[peer] = fd;
+        }
+    }
+    else if (ok)
+    {
+        for (int accepted = 0; accepted < (size + 1) / 2 && ok; accepted++)
+        {
+            // an RU that failed to connect must not leave the BU waiting forever
+            pollfd incoming = {listener, POLLIN, 0};
+            if (poll(&incoming, 1, m_connectTimeout * 1000) <= 0)
+            {
+                std::cerr << "Rank " << rank << ": timed out waiting for RU connections" << std::endl;
+                ok = false;
+                break;
+            }
+
+            int fd = accept(listener, nullptr, nullptr);
+            int32_t peer = -1;
+            ok = fd >= 0 && recv(fd, &peer, sizeof(peer), MSG_WAITALL) == sizeof(peer) && peer >= 0 && peer < size;
+            if (!ok)
+                break;
+
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+            m_sockets[peer] = fd;
+        }
+    }
+
+    if (listener >= 0)
+        close(listener);
+
+    // zero-copy only if every RU got it, so that all describe the same transport
+    int zeroCopy = m_zeroCopy || !isRu;
+    MPI_Allreduce(MPI_IN_PLACE, &zeroCopy, 1, MPI_INT, MPI_MIN, comm);
+    m_zeroCopy = zeroCopy;
+
+    int connected = ok;
+    MPI_Allreduce(MPI_IN_PLACE, &connected, 1, MPI_INT, MPI_MIN, comm);
+    return connected;
+}
+
+std::string TcpTransport::describeTransport() const
+{
+    return m_zeroCopy ? "TCP sockets, MSG_ZEROCOPY sends" : "TCP sockets";
+}
+
+std::size_t TcpTransport::takeCopiedSends()
+{
+    std::size_t copied = m_zeroCopyCopied;
+    m_zeroCopyCopied = 0;
+    return copied;
+}
+
+/**
+ * @brief Send all of iov, IOV_MAX entries per sendmsg(), consuming iov
+ */
+bool TcpTransport::sendGather(int peer, std::vector<iovec> &iov)
+{
+    const int fd = m_sockets[peer];
+    const int flags = MSG_NOSIGNAL | (m_zeroCopy ? MSG_ZEROCOPY : 0);
+    std::size_t first = 0;
+
+    while (first < iov.size())
+    {
+        msghdr message = {};
+        message.msg_iov = &iov[first];
+        message.msg_iovlen = std::min<std::size_t>(iov.size() - first, IOV_MAX);
+
+        ssize_t sent = sendmsg(fd, &message, flags);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == ENOBUFS && m_zeroCopy && waitZeroCopy(peer)) // too many pinned pages in flight
+                continue;
+            return false;
+        }
+
+        if (m_zeroCopy && sent > 0)
+            m_zeroCopySent[peer]++;
+
+        // drop what went out, the last entry may be partial
+        std::size_t remaining = sent;
+        while (first < iov.size() && remaining >= iov[first].iov_len)
+            remaining -= iov[first++].iov_len;
+        if (remaining > 0)
+        {
+            iov[first].iov_base = static_cast<int8_t *>(iov[first].iov_base) + remaining;
+            iov[first].iov_len -= remaining;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Fill all of iov, polling the peer's socket alone between reads, consuming iov
+ */
+bool TcpTransport::receiveScatter(int peer, std::vector<iovec> &iov)
+{
+    const int fd = m_sockets[peer];
+    std::size_t first = 0;
+
+    while (first < iov.size())
+    {
+        // a hang-up or error is reported here too and ends in the recvmsg() below
+        pollfd descriptor = {fd, POLLIN, 0};
+        if (poll(&descriptor, 1, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        msghdr message = {};
+        message.msg_iov = &iov[first];
+        message.msg_iovlen = std::min<std::size_t>(iov.size() - first, IOV_MAX);
+
+        ssize_t received = recvmsg(fd, &message, MSG_DONTWAIT);
+        if (received == 0)
+            return false; // peer closed
+        if (received < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+                continue;
+            return false;
+        }
+
+        std::size_t remaining = received;
+        while (first < iov.size() && remaining >= iov[first].iov_len)
+            remaining -= iov[first++].iov_len;
+        if (remaining > 0)
+        {
+            iov[first].iov_base = static_cast<int8_t *>(iov[first].iov_base) + remaining;
+            iov[first].iov_len -= remaining;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reap MSG_ZEROCOPY completions until every send to peer is done with its pages
+ */
+bool TcpTransport::waitZeroCopy(int peer)
+{
+    if (!m_zeroCopy)
+        return true;
+
+    const int fd = m_sockets[peer];
+    while (m_zeroCopyDone[peer] != m_zeroCopySent[peer])
+    {
+        pollfd descriptor = {fd, 0, 0}; // the error queue is signalled by POLLERR alone
+        if (poll(&descriptor, 1, -1) < 0 && errno != EINTR)
+            return false;
+
+        char control[128];
+        msghdr message = {};
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (recvmsg(fd, &message, MSG_ERRQUEUE) < 0)
+        {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            return false;
+        }
+
+        for (cmsghdr *header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header))
+        {
+            if (!((header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR) ||
+                  (header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR)))
+                continue;
+
+            const sock_extended_err *error = reinterpret_cast<const sock_extended_err *>(CMSG_DATA(header));
+            if (error->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+
+            uint32_t completed = error->ee_data - error->ee_info + 1; // range of send ids
+            m_zeroCopyDone[peer] += completed;
+            if (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+                m_zeroCopyCopied += completed;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief RU side, fragments laid out in the buffer like the MPI modes
+ *
+ * @param batch Hand the whole batch to the socket at once instead of fragment by fragment
+ * @return std::pair<std::size_t, std::size_t> Errors (all fragments if the socket failed) and bytes sent
+ */
+std::pair<std::size_t, std::size_t> TcpTransport::sendFragments(int peer, int8_t *buffer, std::size_t bufferBytes,
+                                                                const std::vector<std::size_t> &sizes, bool batch)
+{
+    std::vector<iovec> iov;
+    iov.reserve(batch ? sizes.size() : 1);
+
+    std::size_t offset = 0, transferredSize = 0;
+    bool ok = true;
+
+    for (std::size_t i = 0; i < sizes.size() && ok; i++)
+    {
+        if (offset + sizes[i] > bufferBytes)
+            offset = 0;
+
+        iov.push_back({buffer + offset, sizes[i]});
+        transferredSize += sizes[i];
+
+        if (!batch)
+        {
+            ok = sendGather(peer, iov);
+            iov.clear();
+        }
+
+        offset = (offset + sizes[i]) % bufferBytes;
+    }
+
+    if (batch && ok)
+        ok = sendGather(peer, iov);
+    ok = ok && waitZeroCopy(peer);
+
+    return ok ? std::make_pair(std::size_t(0), transferredSize) : std::make_pair(sizes.size(), std::size_t(0));
+}
+
+/**
+ * @brief BU side, the counterpart of sendFragments()
+ *
+ * Blocking receives wait with MSG_WAITALL, batches are scattered as poll reports data.
+ */
+std::pair<std::size_t, std::size_t> TcpTransport::receiveFragments(int peer, int8_t *buffer, std::size_t bufferBytes,
+                                                                   const std::vector<std::size_t> &sizes, bool batch)
+{
+    std::vector<iovec> iov;
+    iov.reserve(batch ? sizes.size() : 1);
+
+    std::size_t offset = 0, transferredSize = 0;
+    bool ok = true;
+
+    for (std::size_t i = 0; i < sizes.size() && ok; i++)
+    {
+        if (offset + sizes[i] > bufferBytes)
+            offset = 0;
+
+        if (batch)
+            iov.push_back({buffer + offset, sizes[i]});
+        else
+            ok = recv(m_sockets[peer], buffer + offset, sizes[i], MSG_WAITALL) == static_cast<ssize_t>(sizes[i]);
+        transferredSize += sizes[i];
+
+        offset = (offset + sizes[i]) % bufferBytes;
+    }
+
+    if (batch && ok)
+        ok = receiveScatter(peer, iov);
+
+    return ok ? std::make_pair(std::size_t(0), transferredSize) : std::make_pair(sizes.size(), std::size_t(0));
+}
+
+std::pair<std::size_t, std::size_t> TcpTransport::twoRankBlockingCommunication(int8_t *bufferSnd, int8_t *bufferRcv,
+                                                                               std::size_t sndBufferBytes, std::size_t rcvBufferBytes,
+                                                                               std::size_t messageSize, int rank, std::size_t iterations)
+{
+    std::vector<std::size_t> sizes(iterations, messageSize);
+
+    if (rank == 0)
+        return sendFragments(1, bufferSnd, sndBufferBytes, sizes, false);
+    else if (rank == 1)
+        return receiveFragments(0, bufferRcv, rcvBufferBytes, sizes, false);
+
+    return std::make_pair(0, 0);
+}
+
+std::pair<std::size_t, std::size_t> TcpTransport::blockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                        std::size_t messageSize, std::size_t iterations)
+{
+    std::vector<std::size_t> sizes(iterations, messageSize);
+
+    if (processRank == ruRank)
+        return sendFragments(buRank, unit->getBuffer(), unit->getBufferBytes(), sizes, false);
+    else if (processRank == buRank)
+        return receiveFragments(ruRank, unit->getBuffer(), unit->getBufferBytes(), sizes, false);
+
+    return std::make_pair(0, 0);
+}
+
+std::pair<std::size_t, std::size_t> TcpTransport::nonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                           std::size_t messageSize, std::size_t iterations)
+{
+    std::vector<std::size_t> sizes(iterations, messageSize);
+
+    if (processRank == ruRank)
+        return sendFragments(buRank, unit->getBuffer(), unit->getBufferBytes(), sizes, true);
+    else if (processRank == buRank)
+        return receiveFragments(ruRank, unit->getBuffer(), unit->getBufferBytes(), sizes, true);
+
+    return std::make_pair(0, 0);
+}
+
+/**
+ * @brief Every fragment is preceded by its size, like the MPI variable modes
+ */
+std::pair<std::size_t, std::size_t> TcpTransport::variableBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                                std::size_t firstEvent)
+{
+    std::size_t errorMessageCount = 0;
+    std::size_t transferredSize = 0;
+
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        uint32_t size = messageSizes[(firstEvent + i) % messageSizes.size()];
+        std::pair<std::size_t, std::size_t> result = std::make_pair(0, 0);
+
+        if (processRank == ruRank)
+        {
+            std::vector<iovec> header = {{&size, sizeof(size)}};
+            if (!sendGather(buRank, header) || !waitZeroCopy(buRank))
+                return std::make_pair(iterations - i, transferredSize);
+            result = sendFragments(buRank, unit->getBuffer(), unit->getBufferBytes(), {size}, false);
+        }
+        else if (processRank == buRank)
+        {
+            if (recv(m_sockets[ruRank], &size, sizeof(size), MSG_WAITALL) != sizeof(size))
+                return std::make_pair(iterations - i, transferredSize);
+            result = receiveFragments(ruRank, unit->getBuffer(), unit->getBufferBytes(), {size}, false);
+        }
+
+        errorMessageCount += result.first;
+        transferredSize += result.second;
+    }
+
+    return std::make_pair(errorMessageCount, transferredSize);
+}
+
+/**
+ * @brief The sizes of the batch go first as one table, then the batch as one gather list
+ */
+std::pair<std::size_t, std::size_t> TcpTransport::variableNonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                   const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                                   std::size_t firstEvent)
+{
+    std::vector<uint32_t> table(iterations);
+    std::vector<iovec> header = {{table.data(), table.size() * sizeof(uint32_t)}};
+
+    if (processRank == ruRank)
+    {
+        std::vector<std::size_t> sizes(iterations);
+        for (std::size_t i = 0; i < iterations; i++)
+            sizes[i] = table[i] = messageSizes[(firstEvent + i) % messageSizes.size()];
+
+        if (!sendGather(buRank, header))
+            return std::make_pair(iterations, 0);
+        return sendFragments(buRank, unit->getBuffer(), unit->getBufferBytes(), sizes, true);
+    }
+    else if (processRank == buRank)
+    {
+        if (!receiveScatter(ruRank, header))
+            return std::make_pair(iterations, 0);
+        return receiveFragments(ruRank, unit->getBuffer(), unit->getBufferBytes(),
+                                std::vector<std::size_t>(table.begin(), table.end()), true);
+    }
+
+    return std::make_pair(0, 0);
+}
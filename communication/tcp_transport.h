@@ -0,0 +1,72 @@
+#ifndef TCPTRANSPORT_H
+#define TCPTRANSPORT_H
+
+#include <mpi.h>
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "transport.h"
+
+/**
+ * @brief Fragments over plain TCP sockets, the bare-socket baseline to MPI
+ *
+ * connect() opens one socket from every even rank (RU) to every odd rank (BU), the
+ * addresses being exchanged over MPI: every rank listens on an ephemeral port of all
+ * interfaces and publishes its hostname, which must resolve to the interface to test.
+ * Blocking modes send fragment by fragment, non-blocking modes hand the whole batch to
+ * sendmsg() as one gather list, and the BU scatters it into its buffer as poll reports
+ * the socket readable. With zero-copy, RU sends use MSG_ZEROCOPY and the completions are
+ * reaped from the error queue before a batch returns.
+ */
+class TcpTransport : public Transport
+{
+public:
+    explicit TcpTransport(bool zeroCopy) : m_zeroCopy(zeroCopy) {}
+    ~TcpTransport();
+
+    bool connect(MPI_Comm comm);
+
+    std::string describeTransport() const override;
+    std::size_t takeCopiedSends() override;
+
+    std::pair<std::size_t, std::size_t> twoRankBlockingCommunication(int8_t *bufferSnd, int8_t *bufferRcv,
+                                                                     std::size_t sndBufferBytes, std::size_t rcvBufferBytes,
+                                                                     std::size_t messageSize, int rank, std::size_t iterations) override;
+
+    std::pair<std::size_t, std::size_t> blockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                              std::size_t messageSize, std::size_t iterations) override;
+
+    std::pair<std::size_t, std::size_t> nonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                 std::size_t messageSize, std::size_t iterations) override;
+
+    std::pair<std::size_t, std::size_t> variableBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                      const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                      std::size_t firstEvent = 0) override;
+
+    std::pair<std::size_t, std::size_t> variableNonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                         const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                         std::size_t firstEvent = 0) override;
+
+private:
+    bool sendGather(int peer, std::vector<iovec> &iov);
+    bool receiveScatter(int peer, std::vector<iovec> &iov);
+    bool waitZeroCopy(int peer);
+
+    std::pair<std::size_t, std::size_t> sendFragments(int peer, int8_t *buffer, std::size_t bufferBytes,
+                                                      const std::vector<std::size_t> &sizes, bool batch);
+    std::pair<std::size_t, std::size_t> receiveFragments(int peer, int8_t *buffer, std::size_t bufferBytes,
+                                                         const std::vector<std::size_t> &sizes, bool batch);
+
+    bool m_zeroCopy;
+    const int m_connectTimeout = 60; // s a BU waits for the next RU connection
+    std::vector<int> m_sockets; // per world rank, -1 where not connected
+
+    std::vector<uint32_t> m_zeroCopySent; // per world rank, MSG_ZEROCOPY sends issued
+    std::vector<uint32_t> m_zeroCopyDone; // completions reaped
+    std::size_t m_zeroCopyCopied = 0;     // completions the kernel had to copy (loopback, unsupported NIC), since the last take
+};
+
+#endif // TCPTRANSPORT_H
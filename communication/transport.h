@@ -0,0 +1,48 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Unit;
+
+/**
+ * @brief Single-pair data movement of the fixed, variable and scan modes
+ *
+ * CommunicationInterface is the MPI implementation and the default. Ranks are those of
+ * MPI_COMM_WORLD for other transports, which bootstrap over MPI but move the fragments
+ * themselves. All calls return the failed fragment count and the bytes transferred.
+ */
+class Transport
+{
+public:
+    virtual ~Transport() {}
+
+    virtual std::string describeTransport() const = 0;
+
+    // zero-copy sends the kernel completed by copying since the last call, 0 for transports without zero-copy
+    virtual std::size_t takeCopiedSends() { return 0; }
+
+    virtual std::pair<std::size_t, std::size_t> twoRankBlockingCommunication(int8_t *bufferSnd, int8_t *bufferRcv,
+                                                                             std::size_t sndBufferBytes, std::size_t rcvBufferBytes,
+                                                                             std::size_t messageSize, int rank, std::size_t iterations) = 0;
+
+    virtual std::pair<std::size_t, std::size_t> blockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                      std::size_t messageSize, std::size_t iterations) = 0;
+
+    virtual std::pair<std::size_t, std::size_t> nonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                         std::size_t messageSize, std::size_t iterations) = 0;
+
+    virtual std::pair<std::size_t, std::size_t> variableBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                              const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                              std::size_t firstEvent = 0) = 0;
+
+    virtual std::pair<std::size_t, std::size_t> variableNonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                 const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                                 std::size_t firstEvent = 0) = 0;
+};
+
+#endif // TRANSPORT_H
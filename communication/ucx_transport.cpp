@@ -0,0 +1,502 @@
+#include "ucx_transport.h"
+
+#ifdef EB_WITH_UCX
+
+#include <cstring>
+#include <iostream>
+
+#include "../unit/unit.h"
+
+UcxTransport::~UcxTransport()
+{
+    for (RemoteBuffer &remote : m_remoteBuffers)
+    {
+        if (remote.rkey)
+            ucp_rkey_destroy(remote.rkey);
+    }
+
+    // peers may be gone already, so do not wait for outstanding operations to flush
+    ucp_request_param_t param = {};
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = UCP_EP_CLOSE_FLAG_FORCE;
+    for (ucp_ep_h endpoint : m_endpoints)
+    {
+        if (endpoint)
+            wait(ucp_ep_close_nbx(endpoint, &param));
+    }
+
+    for (auto &registration : m_registrations)
+        ucp_mem_unmap(m_context, registration.second);
+
+    if (m_worker)
+        ucp_worker_destroy(m_worker);
+    if (m_context)
+        ucp_cleanup(m_context);
+}
+
+/**
+ * @brief Create the worker and the RU/BU endpoints (collective over comm)
+ *
+ * @return false if UCX could not be initialised on some rank, the caller aborts
+ */
+bool UcxTransport::connect(MPI_Comm comm)
+{
+    int size;
+    MPI_Comm_rank(comm, &m_rank);
+    MPI_Comm_size(comm, &size);
+
+    ucp_config_t *config = nullptr;
+    bool ok = ucp_config_read(nullptr, nullptr, &config) == UCS_OK;
+
+    if (ok)
+    {
+        ucp_params_t params = {};
+        params.field_mask = UCP_PARAM_FIELD_FEATURES;
+        params.features = UCP_FEATURE_TAG | UCP_FEATURE_RMA;
+        ok = ucp_init(&params, config, &m_context) == UCS_OK;
+        ucp_config_release(config);
+    }
+
+    if (ok)
+    {
+        ucp_worker_params_t params = {};
+        params.field_mask = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+        params.thread_mode = UCS_THREAD_MODE_SINGLE;
+        ok = ucp_worker_create(m_context, &params, &m_worker) == UCS_OK;
+    }
+
+    ucp_address_t *address = nullptr;
+    std::size_t addressLength = 0;
+    if (ok && ucp_worker_get_address(m_worker, &address, &addressLength) != UCS_OK)
+    {
+        ok = false;
+        addressLength = 0;
+    }
+
+    // worker addresses vary in length with the transports found
+    int length = addressLength;
+    std::vector<int> lengths(size), displacements(size);
+    MPI_Allgather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, comm);
+    for (int peer = 1; peer < size; peer++)
+        displacements[peer] = displacements[peer - 1] + lengths[peer - 1];
+
+    std::vector<char> addresses(displacements[size - 1] + lengths[size - 1]);
+    MPI_Allgatherv(address, length, MPI_BYTE, addresses.data(), lengths.data(), displacements.data(), MPI_BYTE, comm);
+    if (address)
+        ucp_worker_release_address(m_worker, address);
+
+    m_endpoints.assign(size, nullptr);
+    m_remoteBuffers.assign(size, RemoteBuffer());
+    m_offeredBuffers.assign(size, nullptr);
+
+    // RUs reach every BU and the other way round, for the rkeys and completion messages
+    for (int peer = (m_rank + 1) % 2; peer < size && ok; peer += 2)
+    {
+        if (lengths[peer] == 0)
+        {
+            ok = false;
+            break;
+        }
+
+        ucp_ep_params_t params = {};
+        params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+        params.address = reinterpret_cast<const ucp_address_t *>(&addresses[displacements[peer]]);
+        if (ucp_ep_create(m_worker, &params, &m_endpoints[peer]) != UCS_OK)
+        {
+            std::cerr << "Rank " << m_rank << ": cannot create a UCX endpoint to rank " << peer << std::endl;
+            ok = false;
+        }
+    }
+
+    int connected = ok;
+    MPI_Allreduce(MPI_IN_PLACE, &connected, 1, MPI_INT, MPI_MIN, comm);
+    return connected;
+}
+
+std::string UcxTransport::describeTransport() const
+{
+    std::string operation = (m_mode == UCX_RMA) ? "ucp_put_nbx" : "ucp_tag_send_nbx";
+    return "UCX " + std::string(ucp_get_version_string()) + ", " + operation;
+}
+
+/**
+ * @brief Progress the worker until request completes and release it
+ *
+ * @param request As returned by a *_nbx call, nullptr if it completed immediately
+ */
+bool UcxTransport::wait(ucs_status_ptr_t request)
+{
+    if (request == nullptr)
+        return true;
+    if (UCS_PTR_IS_ERR(request))
+        return false;
+
+    ucs_status_t status;
+    while ((status = ucp_request_check_status(request)) == UCS_INPROGRESS)
+        ucp_worker_progress(m_worker);
+
+    ucp_request_free(request);
+    return status == UCS_OK;
+}
+
+bool UcxTransport::waitAll(std::vector<ucs_status_ptr_t> &requests)
+{
+    // a single worker progresses all of them, waiting in order costs nothing extra
+    bool ok = true;
+    for (ucs_status_ptr_t request : requests)
+        ok = wait(request) && ok;
+
+    requests.clear();
+    return ok;
+}
+
+/**
+ * @brief Wait until every put to peer is complete at the peer
+ */
+bool UcxTransport::flush(int peer)
+{
+    ucp_request_param_t param = {};
+    return wait(ucp_ep_flush_nbx(m_endpoints[peer], &param));
+}
+
+/**
+ * @brief Memory handle of buffer, mapped on first use
+ *
+ * @return nullptr if the mapping failed, operations then fall back to unregistered buffers
+ */
+ucp_mem_h UcxTransport::registration(int8_t *buffer, std::size_t bufferBytes)
+{
+    auto found = m_registrations.find(buffer);
+    if (found != m_registrations.end())
+        return found->second;
+
+    ucp_mem_map_params_t params = {};
+    params.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS | UCP_MEM_MAP_PARAM_FIELD_LENGTH;
+    params.address = buffer;
+    params.length = bufferBytes;
+
+    ucp_mem_h memh = nullptr;
+    if (ucp_mem_map(m_context, &params, &memh) != UCS_OK)
+        return nullptr;
+
+    m_registrations[buffer] = memh;
+    return memh;
+}
+
+/**
+ * @brief BU side, give peer access to buffer unless it has it already
+ */
+bool UcxTransport::offerKey(int peer, int8_t *buffer, std::size_t bufferBytes)
+{
+    if (m_offeredBuffers[peer] == buffer)
+        return true;
+
+    ucp_mem_h memh = registration(buffer, bufferBytes);
+    void *packedKey = nullptr;
+    std::size_t packedKeyBytes = 0;
+    if (!memh || ucp_rkey_pack(m_context, memh, &packedKey, &packedKeyBytes) != UCS_OK)
+        return false;
+
+    std::vector<int8_t> message(2 * sizeof(uint64_t) + packedKeyBytes);
+    uint64_t header[2] = {reinterpret_cast<uint64_t>(buffer), bufferBytes};
+    std::memcpy(message.data(), header, sizeof(header));
+    std::memcpy(message.data() + sizeof(header), packedKey, packedKeyBytes);
+    ucp_rkey_buffer_release(packedKey);
+
+    if (!sendMessage(peer, MESSAGE_RKEY, message.data(), message.size()))
+        return false;
+
+    m_offeredBuffers[peer] = buffer;
+    return true;
+}
+
+/**
+ * @brief RU side, the counterpart of offerKey(), once per BU
+ */
+bool UcxTransport::receiveKey(int peer)
+{
+    RemoteBuffer &remote = m_remoteBuffers[peer];
+    if (remote.rkey)
+        return true;
+
+    // the packed rkey's length depends on the BU's transports
+    ucp_tag_recv_info_t info;
+    while (!ucp_tag_probe_nb(m_worker, tag(MESSAGE_RKEY, peer), ~ucp_tag_t(0), 0, &info))
+        ucp_worker_progress(m_worker);
+
+    std::vector<int8_t> message(info.length);
+    uint64_t header[2];
+    if (info.length < sizeof(header) || !receiveMessage(peer, MESSAGE_RKEY, message.data(), message.size()))
+        return false;
+
+    std::memcpy(header, message.data(), sizeof(header));
+    remote.address = header[0];
+    remote.bytes = header[1];
+    return ucp_ep_rkey_unpack(m_endpoints[peer], message.data() + sizeof(header), &remote.rkey) == UCS_OK;
+}
+
+/**
+ * @brief Unregistered control message, complete on return
+ */
+bool UcxTransport::sendMessage(int peer, MessageKind kind, const void *data, std::size_t bytes)
+{
+    ucp_request_param_t param = {};
+    return wait(ucp_tag_send_nbx(m_endpoints[peer], data, bytes, tag(kind, m_rank), &param));
+}
+
+bool UcxTransport::receiveMessage(int peer, MessageKind kind, void *data, std::size_t bytes)
+{
+    ucp_request_param_t param = {};
+    return wait(ucp_tag_recv_nbx(m_worker, data, bytes, tag(kind, peer), ~ucp_tag_t(0), &param));
+}
+
+/**
+ * @brief RU side, fragments laid out in the buffer like the MPI modes
+ *
+ * In RMA mode fragments land at the same offsets of the BU buffer, wrapping at its length.
+ *
+ * @param batch Post the whole batch before waiting instead of fragment by fragment
+ * @return std::pair<std::size_t, std::size_t> Errors (all fragments if an operation failed) and bytes sent
+ */
+std::pair<std::size_t, std::size_t> UcxTransport::sendFragments(int peer, int8_t *buffer, std::size_t bufferBytes,
+                                                                const std::vector<std::size_t> &sizes, bool batch)
+{
+    const bool rma = (m_mode == UCX_RMA);
+    if (rma && !receiveKey(peer))
+        return std::make_pair(sizes.size(), std::size_t(0));
+
+    const RemoteBuffer &remote = m_remoteBuffers[peer];
+    ucp_mem_h memh = registration(buffer, bufferBytes);
+
+    ucp_request_param_t param = {};
+    if (memh)
+    {
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_MEMH;
+        param.memh = memh;
+    }
+
+    std::vector<ucs_status_ptr_t> requests;
+    requests.reserve(batch ? sizes.size() : 1);
+
+    std::size_t offset = 0, remoteOffset = 0, transferredSize = 0;
+    bool ok = true;
+
+    for (std::size_t i = 0; i < sizes.size() && ok; i++)
+    {
+        if (offset + sizes[i] > bufferBytes)
+            offset = 0;
+
+        if (rma)
+        {
+            if (remoteOffset + sizes[i] > remote.bytes)
+                remoteOffset = 0;
+            requests.push_back(ucp_put_nbx(m_endpoints[peer], buffer + offset, sizes[i],
+                                           remote.address + remoteOffset, remote.rkey, &param));
+            remoteOffset = (remoteOffset + sizes[i]) % remote.bytes;
+        }
+        else
+        {
+            requests.push_back(ucp_tag_send_nbx(m_endpoints[peer], buffer + offset, sizes[i], tag(MESSAGE_DATA, m_rank), &param));
+        }
+        transferredSize += sizes[i];
+
+        // a blocking put is only done once it is visible at the BU
+        if (!batch)
+            ok = waitAll(requests) && (!rma || flush(peer));
+
+        offset = (offset + sizes[i]) % bufferBytes;
+    }
+
+    ok = waitAll(requests) && ok;
+    if (rma)
+    {
+        uint64_t done = ok ? transferredSize : 0;
+        ok = ok && flush(peer);
+        ok = sendMessage(peer, MESSAGE_DONE, &done, sizeof(done)) && ok;
+    }
+
+    return ok ? std::make_pair(std::size_t(0), transferredSize) : std::make_pair(sizes.size(), std::size_t(0));
+}
+
+/**
+ * @brief BU side, the counterpart of sendFragments()
+ *
+ * In RMA mode the BU only hands out its rkey and waits for the RU's byte count.
+ */
+std::pair<std::size_t, std::size_t> UcxTransport::receiveFragments(int peer, int8_t *buffer, std::size_t bufferBytes,
+                                                                   const std::vector<std::size_t> &sizes, bool batch)
+{
+    if (m_mode == UCX_RMA)
+    {
+        uint64_t done = 0;
+        bool ok = offerKey(peer, buffer, bufferBytes) && receiveMessage(peer, MESSAGE_DONE, &done, sizeof(done)) && done > 0;
+        return ok ? std::make_pair(std::size_t(0), std::size_t(done)) : std::make_pair(sizes.size(), std::size_t(0));
+    }
+
+    ucp_mem_h memh = registration(buffer, bufferBytes);
+
+    ucp_request_param_t param = {};
+    if (memh)
+    {
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_MEMH;
+        param.memh = memh;
+    }
+
+    std::vector<ucs_status_ptr_t> requests;
+    requests.reserve(batch ? sizes.size() : 1);
+
+    std::size_t offset = 0, transferredSize = 0;
+    bool ok = true;
+
+    for (std::size_t i = 0; i < sizes.size() && ok; i++)
+    {
+        if (offset + sizes[i] > bufferBytes)
+            offset = 0;
+
+        requests.push_back(ucp_tag_recv_nbx(m_worker, buffer + offset, sizes[i], tag(MESSAGE_DATA, peer), ~ucp_tag_t(0), &param));
+        transferredSize += sizes[i];
+
+        if (!batch)
+            ok = waitAll(requests);
+
+        offset = (offset + sizes[i]) % bufferBytes;
+    }
+
+    ok = waitAll(requests) && ok;
+
+    return ok ? std::make_pair(std::size_t(0), transferredSize) : std::make_pair(sizes.size(), std::size_t(0));
+}
+
+/**
+ * @brief BU side of variable blocking tag sends, every fragment's size taken from a probe
+ */
+std::pair<std::size_t, std::size_t> UcxTransport::receiveProbed(int peer, int8_t *buffer, std::size_t bufferBytes, std::size_t count)
+{
+    ucp_request_param_t param = {};
+    ucp_mem_h memh = registration(buffer, bufferBytes);
+    if (memh)
+    {
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_MEMH;
+        param.memh = memh;
+    }
+
+    std::size_t offset = 0, transferredSize = 0;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        ucp_tag_recv_info_t info;
+        while (!ucp_tag_probe_nb(m_worker, tag(MESSAGE_DATA, peer), ~ucp_tag_t(0), 0, &info))
+            ucp_worker_progress(m_worker);
+
+        if (info.length > bufferBytes)
+            return std::make_pair(count - i, transferredSize);
+        if (offset + info.length > bufferBytes)
+            offset = 0;
+
+        if (!wait(ucp_tag_recv_nbx(m_worker, buffer + offset, info.length, tag(MESSAGE_DATA, peer), ~ucp_tag_t(0), &param)))
+            return std::make_pair(count - i, transferredSize);
+        transferredSize += info.length;
+
+        offset = (offset + info.length) % bufferBytes;
+    }
+
+    return std::make_pair(0, transferredSize);
+}
+
+std::pair<std::size_t, std::size_t> UcxTransport::twoRankBlockingCommunication(int8_t *bufferSnd, int8_t *bufferRcv,
+                                                                               std::size_t sndBufferBytes, std::size_t rcvBufferBytes,
+                                                                               std::size_t messageSize, int rank, std::size_t iterations)
+{
+    std::vector<std::size_t> sizes(iterations, messageSize);
+
+    if (rank == 0)
+        return sendFragments(1, bufferSnd, sndBufferBytes, sizes, false);
+    else if (rank == 1)
+        return receiveFragments(0, bufferRcv, rcvBufferBytes, sizes, false);
+
+    return std::make_pair(0, 0);
+}
+
+std::pair<std::size_t, std::size_t> UcxTransport::blockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                        std::size_t messageSize, std::size_t iterations)
+{
+    std::vector<std::size_t> sizes(iterations, messageSize);
+
+    if (processRank == ruRank)
+        return sendFragments(buRank, unit->getBuffer(), unit->getBufferBytes(), sizes, false);
+    else if (processRank == buRank)
+        return receiveFragments(ruRank, unit->getBuffer(), unit->getBufferBytes(), sizes, false);
+
+    return std::make_pair(0, 0);
+}
+
+std::pair<std::size_t, std::size_t> UcxTransport::nonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                           std::size_t messageSize, std::size_t iterations)
+{
+    std::vector<std::size_t> sizes(iterations, messageSize);
+
+    if (processRank == ruRank)
+        return sendFragments(buRank, unit->getBuffer(), unit->getBufferBytes(), sizes, true);
+    else if (processRank == buRank)
+        return receiveFragments(ruRank, unit->getBuffer(), unit->getBufferBytes(), sizes, true);
+
+    return std::make_pair(0, 0);
+}
+
+/**
+ * @brief Tag receives learn every fragment's size from a probe, RMA needs no sizes at the BU
+ */
+std::pair<std::size_t, std::size_t> UcxTransport::variableBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                                std::size_t firstEvent)
+{
+    if (processRank == ruRank)
+    {
+        std::vector<std::size_t> sizes(iterations);
+        for (std::size_t i = 0; i < iterations; i++)
+            sizes[i] = messageSizes[(firstEvent + i) % messageSizes.size()];
+
+        return sendFragments(buRank, unit->getBuffer(), unit->getBufferBytes(), sizes, false);
+    }
+    else if (processRank == buRank)
+    {
+        if (m_mode == UCX_RMA)
+            return receiveFragments(ruRank, unit->getBuffer(), unit->getBufferBytes(), std::vector<std::size_t>(iterations), false);
+        return receiveProbed(ruRank, unit->getBuffer(), unit->getBufferBytes(), iterations);
+    }
+
+    return std::make_pair(0, 0);
+}
+
+/**
+ * @brief Tag sends are preceded by the batch's size table so the BU can post all receives
+ */
+std::pair<std::size_t, std::size_t> UcxTransport::variableNonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                                   const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                                   std::size_t firstEvent)
+{
+    std::vector<uint32_t> table(iterations);
+    const bool rma = (m_mode == UCX_RMA);
+
+    if (processRank == ruRank)
+    {
+        std::vector<std::size_t> sizes(iterations);
+        for (std::size_t i = 0; i < iterations; i++)
+            sizes[i] = table[i] = messageSizes[(firstEvent + i) % messageSizes.size()];
+
+        if (!rma && !sendMessage(buRank, MESSAGE_TABLE, table.data(), table.size() * sizeof(uint32_t)))
+            return std::make_pair(iterations, 0);
+        return sendFragments(buRank, unit->getBuffer(), unit->getBufferBytes(), sizes, true);
+    }
+    else if (processRank == buRank)
+    {
+        if (!rma && !receiveMessage(ruRank, MESSAGE_TABLE, table.data(), table.size() * sizeof(uint32_t)))
+            return std::make_pair(iterations, 0);
+        return receiveFragments(ruRank, unit->getBuffer(), unit->getBufferBytes(),
+                                std::vector<std::size_t>(table.begin(), table.end()), true);
+    }
+
+    return std::make_pair(0, 0);
+}
+
+#endif // EB_WITH_UCX
@@ -0,0 +1,110 @@
+#ifndef UCXTRANSPORT_H
+#define UCXTRANSPORT_H
+
+#ifdef EB_WITH_UCX
+
+#include <mpi.h>
+#include <ucp/api/ucp.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "transport.h"
+
+enum UcxMode
+{
+    UCX_TAG, // ucp_tag_send_nbx / ucp_tag_recv_nbx, the path MPI's UCX PML takes
+    UCX_RMA  // ucp_put_nbx into the BU buffer, completion announced by a tag message
+};
+
+/**
+ * @brief Fragments over UCP directly, to measure what the MPI layer on top of UCX costs
+ *
+ * connect() creates one worker per rank and endpoints between every RU and every BU, the
+ * worker addresses being exchanged over MPI. Buffers are registered with ucp_mem_map() the
+ * first time they are used and stay registered. In RMA mode every BU sends its buffer's
+ * address and packed rkey to an RU on their first batch, the RU then puts the fragments
+ * straight into the BU buffer, flushes the endpoint and sends the byte count as a tag
+ * message, which is all the BU waits for. Completion is polled with ucp_worker_progress().
+ *
+ * UCX picks its transports from the environment, e.g. UCX_TLS=shm,tcp for local tests.
+ * Requires UCX 1.14 or newer, build with -DEB_WITH_UCX and link -lucp -lucs.
+ */
+class UcxTransport : public Transport
+{
+public:
+    explicit UcxTransport(UcxMode mode) : m_mode(mode) {}
+    ~UcxTransport();
+
+    bool connect(MPI_Comm comm);
+
+    std::string describeTransport() const override;
+
+    std::pair<std::size_t, std::size_t> twoRankBlockingCommunication(int8_t *bufferSnd, int8_t *bufferRcv,
+                                                                     std::size_t sndBufferBytes, std::size_t rcvBufferBytes,
+                                                                     std::size_t messageSize, int rank, std::size_t iterations) override;
+
+    std::pair<std::size_t, std::size_t> blockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                              std::size_t messageSize, std::size_t iterations) override;
+
+    std::pair<std::size_t, std::size_t> nonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                 std::size_t messageSize, std::size_t iterations) override;
+
+    std::pair<std::size_t, std::size_t> variableBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                      const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                      std::size_t firstEvent = 0) override;
+
+    std::pair<std::size_t, std::size_t> variableNonBlockingCommunication(Unit *unit, int ruRank, int buRank, int processRank,
+                                                                         const std::vector<std::size_t> &messageSizes, std::size_t iterations,
+                                                                         std::size_t firstEvent = 0) override;
+
+private:
+    struct RemoteBuffer
+    {
+        uint64_t address = 0;
+        uint64_t bytes = 0;
+        ucp_rkey_h rkey = nullptr;
+    };
+
+    enum MessageKind : uint64_t
+    {
+        MESSAGE_DATA,
+        MESSAGE_TABLE, // sizes of a variable batch
+        MESSAGE_RKEY,  // BU buffer address, length and packed rkey
+        MESSAGE_DONE   // bytes put by the RU
+    };
+
+    static ucp_tag_t tag(MessageKind kind, int source) { return (uint64_t(kind) << 32) | uint32_t(source); }
+
+    bool wait(ucs_status_ptr_t request);
+    bool waitAll(std::vector<ucs_status_ptr_t> &requests);
+    bool flush(int peer);
+
+    ucp_mem_h registration(int8_t *buffer, std::size_t bufferBytes);
+    bool offerKey(int peer, int8_t *buffer, std::size_t bufferBytes);
+    bool receiveKey(int peer);
+
+    bool sendMessage(int peer, MessageKind kind, const void *data, std::size_t bytes);
+    bool receiveMessage(int peer, MessageKind kind, void *data, std::size_t bytes);
+
+    std::pair<std::size_t, std::size_t> sendFragments(int peer, int8_t *buffer, std::size_t bufferBytes,
+                                                      const std::vector<std::size_t> &sizes, bool batch);
+    std::pair<std::size_t, std::size_t> receiveFragments(int peer, int8_t *buffer, std::size_t bufferBytes,
+                                                         const std::vector<std::size_t> &sizes, bool batch);
+    std::pair<std::size_t, std::size_t> receiveProbed(int peer, int8_t *buffer, std::size_t bufferBytes, std::size_t count);
+
+    UcxMode m_mode;
+    int m_rank = -1;
+    ucp_context_h m_context = nullptr;
+    ucp_worker_h m_worker = nullptr;
+    std::vector<ucp_ep_h> m_endpoints;              // per world rank, nullptr for same-type ranks
+    std::map<int8_t *, ucp_mem_h> m_registrations;  // ucp_mem_map() once per buffer
+    std::vector<RemoteBuffer> m_remoteBuffers;      // RU: BU buffers, RMA mode
+    std::vector<int8_t *> m_offeredBuffers;         // BU: buffer whose rkey each RU holds
+};
+
+#endif // EB_WITH_UCX
+
+#endif // UCXTRANSPORT_H
@@ -0,0 +1,32 @@
+#include "cpu_usage.h"
+
+CpuUsage CpuUsage::now()
+{
+    CpuUsage usage;
+
+    rusage resources;
+    if (getrusage(RUSAGE_SELF, &resources) == 0)
+    {
+        usage.userTime = resources.ru_utime.tv_sec + resources.ru_utime.tv_usec / 1e6;
+        usage.systemTime = resources.ru_stime.tv_sec + resources.ru_stime.tv_usec / 1e6;
+        usage.voluntarySwitches = resources.ru_nvcsw;
+        usage.involuntarySwitches = resources.ru_nivcsw;
+    }
+
+    timespec threadTime;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &threadTime) == 0)
+        usage.threadTime = threadTime.tv_sec + threadTime.tv_nsec / 1e9;
+
+    return usage;
+}
+
+CpuUsage CpuUsage::operator-(const CpuUsage &start) const
+{
+    CpuUsage difference;
+    difference.userTime = userTime - start.userTime;
+    difference.systemTime = systemTime - start.systemTime;
+    difference.threadTime = threadTime - start.threadTime;
+    difference.voluntarySwitches = voluntarySwitches - start.voluntarySwitches;
+    difference.involuntarySwitches = involuntarySwitches - start.involuntarySwitches;
+    return difference;
+}
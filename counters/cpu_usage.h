@@ -0,0 +1,27 @@
+#ifndef CPUUSAGE_H
+#define CPUUSAGE_H
+
+#include <sys/resource.h>
+#include <time.h>
+
+/**
+ * @brief Snapshot of the CPU time and context switches consumed so far
+ *
+ * Process figures include helper threads (e.g. the partitioned mode's readout),
+ * the thread time is the calling thread's only, i.e. the one driving MPI.
+ */
+struct CpuUsage
+{
+    double userTime = 0.0; // s, whole process
+    double systemTime = 0.0;
+    double threadTime = 0.0; // s, calling thread
+    long voluntarySwitches = 0;
+    long involuntarySwitches = 0;
+
+    static CpuUsage now();
+
+    CpuUsage operator-(const CpuUsage &start) const;
+    double processTime() const { return userTime + systemTime; }
+};
+
+#endif // CPUUSAGE_H
@@ -0,0 +1,132 @@
+#include "hardware_counters.h"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+HardwareCounterValues HardwareCounterValues::operator-(const HardwareCounterValues &start) const
+{
+    HardwareCounterValues difference;
+    for (int counter = 0; counter < COUNTER_COUNT; counter++)
+    {
+        difference.available[counter] = available[counter];
+        difference.values[counter] = values[counter] - start.values[counter];
+    }
+    return difference;
+}
+
+HardwareCounters::~HardwareCounters()
+{
+    for (int fd : m_fds)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+/**
+ * @brief Open all counters, kernel time included if permitted
+ *
+ * @return true if at least one counter is available
+ */
+bool HardwareCounters::open()
+{
+    const uint64_t cacheMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const std::pair<uint32_t, uint64_t> events[COUNTER_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | cacheMiss},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | cacheMiss}};
+
+    for (int counter = 0; counter < COUNTER_COUNT; counter++)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = events[counter].first;
+        attributes.config = events[counter].second;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attributes.inherit = 1;
+        attributes.exclude_hv = 1;
+
+        // this process on any CPU; user space only if the kernel is off limits (perf_event_paranoid >= 2)
+        m_fds[counter] = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+        if (m_fds[counter] < 0 && (errno == EACCES || errno == EPERM))
+        {
+            attributes.exclude_kernel = 1;
+            m_fds[counter] = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+        }
+
+        if (m_fds[counter] < 0)
+            m_errors += std::string(m_errors.empty() ? "" : ", ") + counterName(static_cast<HardwareCounter>(counter)) + ": " + std::strerror(errno);
+    }
+
+    return isOpen();
+}
+
+bool HardwareCounters::isOpen() const
+{
+    for (int fd : m_fds)
+    {
+        if (fd >= 0)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Current counts, scaled up if the kernel had to multiplex the counters
+ */
+HardwareCounterValues HardwareCounters::read() const
+{
+    HardwareCounterValues result;
+
+    for (int counter = 0; counter < COUNTER_COUNT; counter++)
+    {
+        uint64_t data[3]; // value, time enabled, time running
+        if (m_fds[counter] < 0 || ::read(m_fds[counter], data, sizeof(data)) != sizeof(data))
+            continue;
+
+        result.available[counter] = true;
+        result.values[counter] = (data[2] > 0 && data[2] < data[1]) ? static_cast<uint64_t>(data[0] * (double(data[1]) / data[2])) : data[0];
+    }
+
+    return result;
+}
+
+std::string HardwareCounters::describe() const
+{
+    std::string description;
+    for (int counter = 0; counter < COUNTER_COUNT; counter++)
+    {
+        if (m_fds[counter] >= 0)
+            description += std::string(description.empty() ? "" : ", ") + counterName(static_cast<HardwareCounter>(counter));
+    }
+
+    if (description.empty())
+        description = "none";
+    if (!m_errors.empty())
+        description += " (unavailable: " + m_errors + ")";
+
+    return description;
+}
+
+const char *HardwareCounters::counterName(HardwareCounter counter)
+{
+    switch (counter)
+    {
+    case COUNTER_CYCLES:
+        return "cycles";
+    case COUNTER_INSTRUCTIONS:
+        return "instructions";
+    case COUNTER_LLC_MISSES:
+        return "LLC misses";
+    case COUNTER_DTLB_MISSES:
+        return "dTLB misses";
+    default:
+        return "unknown";
+    }
+}
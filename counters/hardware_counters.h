@@ -0,0 +1,50 @@
+#ifndef HARDWARECOUNTERS_H
+#define HARDWARECOUNTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum HardwareCounter
+{
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_LLC_MISSES,
+    COUNTER_DTLB_MISSES,
+    COUNTER_COUNT
+};
+
+struct HardwareCounterValues
+{
+    uint64_t values[COUNTER_COUNT] = {};
+    bool available[COUNTER_COUNT] = {}; // counter could be opened on this rank
+
+    HardwareCounterValues operator-(const HardwareCounterValues &start) const;
+};
+
+/**
+ * @brief CPU performance counters of this process, read through perf_event_open
+ *
+ * Every counter is opened on its own so that missing ones (no PMU in a VM,
+ * perf_event_paranoid, unsupported event) only disable themselves. Counting
+ * starts at open() and is inherited by threads created afterwards.
+ */
+class HardwareCounters
+{
+public:
+    ~HardwareCounters();
+
+    bool open();
+    bool isOpen() const;
+
+    HardwareCounterValues read() const;
+
+    std::string describe() const;
+    static const char *counterName(HardwareCounter counter);
+
+private:
+    int m_fds[COUNTER_COUNT] = {-1, -1, -1, -1};
+    std::string m_errors; // counters that failed to open, with the reason
+};
+
+#endif // HARDWARECOUNTERS_H
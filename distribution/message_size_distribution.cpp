@@ -0,0 +1,226 @@
+#include "message_size_distribution.h"
+
+/**
+ * @brief Standard normal quantile (Acklam's rational approximation)
+ *
+ * Relative error below 1.2e-9, more than enough for picking fragment sizes.
+ *
+ * @param p Probability in (0, 1)
+ * @return double
+ */
+double inverseNormalCdf(double p)
+{
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+
+    const double pLow = 0.02425;
+    double q, r;
+
+    p = std::min(std::max(p, 1e-12), 1.0 - 1e-12);
+
+    if (p < pLow)
+    {
+        q = std::sqrt(-2 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    if (p > 1 - pLow)
+    {
+        q = std::sqrt(-2 * std::log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+
+    q = p - 0.5;
+    r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+std::string UniformSizeDistribution::describe() const
+{
+    std::ostringstream oss;
+    oss << "uniform (" << static_cast<std::size_t>(m_lowerBound) << " B - " << static_cast<std::size_t>(m_upperBound) << " B)";
+    return oss.str();
+}
+
+double LogNormalSizeDistribution::quantile(double p) const
+{
+    return m_median * std::exp(m_sigma * inverseNormalCdf(p));
+}
+
+std::string LogNormalSizeDistribution::describe() const
+{
+    std::ostringstream oss;
+    oss << "log-normal (median " << static_cast<std::size_t>(m_median) << " B, sigma " << m_sigma << ")";
+    return oss.str();
+}
+
+/**
+ * @brief Mixture quantile, low mode for p below the weight
+ *
+ * Not the exact quantile of the mixture, but monotone in p within each mode
+ * and with large p always mapping to the high mode, so correlation between
+ * RUs carries over to which mode an event falls into.
+ */
+double BimodalSizeDistribution::quantile(double p) const
+{
+    if (p < m_weight)
+        return m_low.quantile(p / m_weight);
+    return m_high.quantile((p - m_weight) / (1.0 - m_weight));
+}
+
+std::string BimodalSizeDistribution::describe() const
+{
+    std::ostringstream oss;
+    oss << "bimodal (" << m_weight << " x " << m_low.describe() << ", " << (1.0 - m_weight) << " x " << m_high.describe() << ")";
+    return oss.str();
+}
+
+EmpiricalSizeDistribution::EmpiricalSizeDistribution(std::vector<std::size_t> sizes, std::vector<double> weights)
+{
+    std::vector<std::size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&sizes](std::size_t l, std::size_t r)
+              { return sizes[l] < sizes[r]; });
+
+    double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double cumulative = 0.0;
+
+    for (std::size_t idx : order)
+    {
+        cumulative += weights[idx] / total;
+        m_sizes.push_back(sizes[idx]);
+        m_cdf.push_back(cumulative);
+    }
+}
+
+/**
+ * @brief Load histogram file
+ *
+ * One bin per line: "<size in bytes> <count or weight>". Lines starting with # are skipped.
+ *
+ * @param path
+ * @return std::unique_ptr<EmpiricalSizeDistribution> nullptr if the file is unreadable or empty
+ */
+std::unique_ptr<EmpiricalSizeDistribution> EmpiricalSizeDistribution::fromFile(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return nullptr;
+
+    std::vector<std::size_t> sizes;
+    std::vector<double> weights;
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream iss(line);
+        std::size_t size;
+        double weight;
+        if (iss >> size >> weight && weight > 0)
+        {
+            sizes.push_back(size);
+            weights.push_back(weight);
+        }
+    }
+
+    if (sizes.empty())
+        return nullptr;
+
+    return std::make_unique<EmpiricalSizeDistribution>(sizes, weights);
+}
+
+double EmpiricalSizeDistribution::quantile(double p) const
+{
+    std::size_t idx = std::lower_bound(m_cdf.begin(), m_cdf.end(), p) - m_cdf.begin();
+    return m_sizes[std::min(idx, m_sizes.size() - 1)];
+}
+
+std::string EmpiricalSizeDistribution::describe() const
+{
+    std::ostringstream oss;
+    oss << "empirical (" << m_sizes.size() << " bins, " << m_sizes.front() << " B - " << m_sizes.back() << " B)";
+    return oss.str();
+}
+
+/**
+ * @brief Parse distribution specification
+ *
+ * uniform:<min>,<max> | lognormal:<median>,<sigma> | bimodal:<weight>,<median low>,<median high>,<sigma> | histogram:<path>
+ *
+ * @param spec
+ * @return std::unique_ptr<MessageSizeDistribution> nullptr for an invalid specification
+ */
+std::unique_ptr<MessageSizeDistribution> createMessageSizeDistribution(const std::string &spec)
+{
+    std::string name = spec.substr(0, spec.find(':'));
+    std::string params = (spec.find(':') == std::string::npos) ? "" : spec.substr(spec.find(':') + 1);
+
+    if (name == "histogram")
+        return EmpiricalSizeDistribution::fromFile(params);
+
+    std::vector<double> values;
+    std::istringstream iss(params);
+    std::string token;
+    while (std::getline(iss, token, ','))
+        values.push_back(std::atof(token.c_str()));
+
+    if (name == "uniform" && values.size() == 2 && values[0] <= values[1])
+        return std::make_unique<UniformSizeDistribution>(values[0], values[1]);
+    if (name == "lognormal" && values.size() == 2 && values[0] > 0)
+        return std::make_unique<LogNormalSizeDistribution>(values[0], values[1]);
+    if (name == "bimodal" && values.size() == 4 && values[0] > 0 && values[0] < 1)
+        return std::make_unique<BimodalSizeDistribution>(values[0], values[1], values[2], values[3]);
+
+    return nullptr;
+}
+
+/**
+ * @brief Pre-generate fragment sizes for one unit
+ *
+ * Each event draws a standard normal shared by all units (same eventSeed everywhere)
+ * and one private to the unit (unitSeed), mixed by a Gaussian copula:
+ * z = rho * z_event + sqrt(1 - rho^2) * z_unit. With correlation 1 every RU sends
+ * the same quantile of its distribution for a given event, with 0 they are independent.
+ *
+ * @param distribution
+ * @param count Number of events
+ * @param minSize Lower clamp (bytes)
+ * @param maxSize Upper clamp (bytes), normally the buffer size
+ * @param eventSeed Seed common to all units
+ * @param unitSeed Seed unique to this unit
+ * @param correlation Correlation coefficient of the underlying normals, 0..1
+ * @return std::vector<std::size_t>
+ */
+std::vector<std::size_t> generateMessageSizeSequence(const MessageSizeDistribution &distribution, std::size_t count,
+                                                     std::size_t minSize, std::size_t maxSize,
+                                                     unsigned eventSeed, unsigned unitSeed, double correlation)
+{
+    std::mt19937 eventGenerator(eventSeed);
+    std::mt19937 unitGenerator(unitSeed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    double independent = std::sqrt(1.0 - correlation * correlation);
+
+    std::vector<std::size_t> sizes(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        double z = correlation * normal(eventGenerator) + independent * normal(unitGenerator);
+        double p = 0.5 * std::erfc(-z / std::sqrt(2.0));
+
+        double size = std::round(distribution.quantile(p));
+        sizes[i] = static_cast<std::size_t>(std::min(std::max(size, static_cast<double>(minSize)), static_cast<double>(maxSize)));
+    }
+
+    return sizes;
+}
@@ -0,0 +1,95 @@
+#ifndef MESSAGESIZEDISTRIBUTION_H
+#define MESSAGESIZEDISTRIBUTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Fragment size distribution expressed through its quantile function
+ *
+ * Sizes are drawn by inverse transform sampling, which lets RUs share
+ * a per-event random variable and still produce sizes in their own distribution.
+ */
+class MessageSizeDistribution
+{
+public:
+    virtual ~MessageSizeDistribution() {}
+
+    virtual double quantile(double p) const = 0;
+    virtual std::string describe() const = 0;
+};
+
+class UniformSizeDistribution : public MessageSizeDistribution
+{
+public:
+    UniformSizeDistribution(double lowerBound, double upperBound) : m_lowerBound(lowerBound), m_upperBound(upperBound) {}
+
+    double quantile(double p) const override { return m_lowerBound + p * (m_upperBound - m_lowerBound); }
+    std::string describe() const override;
+
+private:
+    double m_lowerBound;
+    double m_upperBound;
+};
+
+class LogNormalSizeDistribution : public MessageSizeDistribution
+{
+public:
+    LogNormalSizeDistribution(double median, double sigma) : m_median(median), m_sigma(sigma) {}
+
+    double quantile(double p) const override;
+    std::string describe() const override;
+
+private:
+    double m_median;
+    double m_sigma;
+};
+
+class BimodalSizeDistribution : public MessageSizeDistribution
+{
+public:
+    BimodalSizeDistribution(double weight, double lowMedian, double highMedian, double sigma)
+        : m_weight(weight), m_low(lowMedian, sigma), m_high(highMedian, sigma) {}
+
+    double quantile(double p) const override;
+    std::string describe() const override;
+
+private:
+    double m_weight; // probability of the low mode
+    LogNormalSizeDistribution m_low;
+    LogNormalSizeDistribution m_high;
+};
+
+class EmpiricalSizeDistribution : public MessageSizeDistribution
+{
+public:
+    EmpiricalSizeDistribution(std::vector<std::size_t> sizes, std::vector<double> weights);
+
+    static std::unique_ptr<EmpiricalSizeDistribution> fromFile(const std::string &path);
+
+    double quantile(double p) const override;
+    std::string describe() const override;
+
+private:
+    std::vector<std::size_t> m_sizes;
+    std::vector<double> m_cdf;
+};
+
+double inverseNormalCdf(double p);
+
+std::unique_ptr<MessageSizeDistribution> createMessageSizeDistribution(const std::string &spec);
+
+std::vector<std::size_t> generateMessageSizeSequence(const MessageSizeDistribution &distribution, std::size_t count,
+                                                     std::size_t minSize, std::size_t maxSize,
+                                                     unsigned eventSeed, unsigned unitSeed, double correlation);
+
+#endif // MESSAGESIZEDISTRIBUTION_H
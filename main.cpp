@@ -22,14 +22,23 @@ void printHelp()
     std::cout << "  Scan run (-mode scan)\n";
     std::cout << "  Fixed message size run (-mode fixed)\n";
     std::cout << "  Variable message size run (-mode variable)\n";
-    std::cout << "  Use non-blocking mode (-n).\n\n";
+    std::cout << "  Use non-blocking mode (-n).\n";
+    std::cout << "  Export a Chrome trace / Perfetto timeline of all ranks (-E path), appended to after every round.\n";
+    std::cout << "  Synchronise clocks against rank 0 at startup and between rounds (-y), logs barrier arrival skew\n";
+    std::cout << "  and, in blocking and paced fixed runs, one-way RU to BU fragment latency.\n";
+    std::cout << "  Sample hardware counters (cycles, instructions, LLC and dTLB misses) per phase / scan size (-H).\n";
+    std::cout << "  Move fragments over another transport (-X mpi | tcp | tcp-zerocopy | ucx | ucx-rma), blocking and\n";
+    std::cout << "  non-blocking modes only. TCP connects every RU to every BU at startup over the address of each hostname.\n";
+    std::cout << "  UCX (tag or put) needs a build with -DEB_WITH_UCX, its transports are chosen by UCX_TLS.\n\n";
 
     std::cout << "  SCAN RUN:\n";
     std::cout << "    <max power>           Set the maximum power of 2 for message sizes.\n";
     std::cout << "    <iterations>          Specify the number of iterations.\n";
     std::cout << "    <send buffer size>    Set the size of the send buffer in messages.\n";
     std::cout << "    <receive buffer size> Set the size of the receive buffer in messages.\n";
-    std::cout << "    <warmup iterations>   Set the number of warmup iterations.\n\n";
+    std::cout << "    <warmup iterations>   Set the number of warmup iterations.\n";
+    std::cout << "    <trials>              Repeat each message size, report mean/median/stddev/95% CI,\n";
+    std::cout << "                          outliers rejected from 5 trials on.\n\n";
 
     std::cout << "  FIXED MESSAGE SIZE RUN:\n";
     std::cout << "    <message size>        Set the fixed message size.\n";
@@ -39,7 +48,29 @@ void printHelp()
     std::cout << "    <BU buffer bytes>     Set the size of the receive buffer in bytes.\n";
     std::cout << "    <warmup iterations>   Set the number of warmup iterations.\n";
     std::cout << "    <logging interval>    Set the interval for average throughput logging in seconds.\n";
-    std::cout << "    <config path>         Configuration json with info on the hosts.\n\n";
+    std::cout << "    <config path>         Configuration json with info on the hosts.\n";
+    std::cout << "    <trials>              Repeat each phase, report mean/median/stddev/95% CI,\n";
+    std::cout << "                          outliers rejected from 5 trials on.\n";
+    std::cout << "    <record trace>        Record RU fragment sizes and inter-arrival times (-R path, {ru} = RU id).\n";
+    std::cout << "    <event rates>         Paced open-loop mode, comma-separated fragment rates per RU in Hz (-e),\n";
+    std::cout << "                          one rate per round of phases, latency logged per phase.\n";
+    std::cout << "    <fan-in>              Incast mode, number of RUs sending to one BU at once (-k). Per-sender\n";
+    std::cout << "                          one-way latency percentiles with -y, fragment service times without.\n";
+    std::cout << "    <fan-out>             Fan-out mode, every RU sends to k BUs and every BU receives\n";
+    std::cout << "                          from k RUs per phase, non-blocking with a window per peer (-F).\n";
+    std::cout << "    <stripe size>         Striped mode, fragments cut into stripes of this many bytes, sent\n";
+    std::cout << "                          round-robin over rail communicators, per-communicator throughput logged\n";
+    std::cout << "                          as stripe channels (-S). Devices are the MPI transport's choice, not one per rail.\n";
+    std::cout << "    <rails>               Number of rail communicators of the striped mode, default 2 (-u).\n";
+    std::cout << "    <partitions>          Partitioned mode, a readout thread fills fragments partition by\n";
+    std::cout << "                          partition and each is sent as soon as it is ready (-q).\n";
+    std::cout << "    <readout rate>        Fill rate of the partitioned mode's readout in Mbit/s, default unpaced (-Q).\n";
+    std::cout << "    Pipelined mode (-P)   Non-blocking, BUs pre-post the next phase's receives into the other\n";
+    std::cout << "                          half of their buffer. Phase-switch gaps are logged for -n and -P.\n";
+    std::cout << "    Shared memory (-M)    Blocking and non-blocking modes, RUs keep their fragments in an\n";
+    std::cout << "                          MPI_Win_allocate_shared segment and co-located BUs get their offsets,\n";
+    std::cout << "                          no copy (throughput = hand-over rate). Intra-node and inter-node pairs\n";
+    std::cout << "                          are reported separately in any case.\n\n";
 
     std::cout << "  VARIABLE MESSAGE SIZE RUN:\n";
     std::cout << "    <message size variants> Set the number of message size variants.\n";
@@ -49,7 +80,30 @@ void printHelp()
     std::cout << "    <BU buffer bytes>       Set the size of the receive buffer in bytes.\n";
     std::cout << "    <warmup iterations>     Set the number of warmup iterations.\n";
     std::cout << "    <logging interval>      Set the interval for average throughput logging in seconds.\n";
-    std::cout << "    <config path>           Configuration json with info on the hosts.\n\n";
+    std::cout << "    <config path>           Configuration json with info on the hosts.\n";
+    std::cout << "    <trials>                Repeat each phase, report mean/median/stddev/95% CI,\n";
+    std::cout << "                            outliers rejected from 5 trials on.\n";
+    std::cout << "    <size distribution>     uniform:<min>,<max> | lognormal:<median>,<sigma> |\n";
+    std::cout << "                            bimodal:<weight>,<median low>,<median high>,<sigma> | histogram:<path>\n";
+    std::cout << "    <size correlation>      Per-event fragment size correlation across RUs (0-1).\n";
+    std::cout << "    <record trace>          Record RU fragment sizes and inter-arrival times (-R path, {ru} = RU id).\n";
+    std::cout << "    <replay trace>          Replay a recorded trace instead of generated sizes (-T path, {ru} = RU id).\n\n";
+
+    std::cout << "  FIXED AND VARIABLE RUNS:\n";
+    std::cout << "    <communicator scope>  world | phase | pair, dedicated communicators created at startup (-g).\n";
+    std::cout << "    Any-source mode (-a)  BUs receive with MPI_ANY_SOURCE, matching worst case.\n";
+    std::cout << "    NIC pinning (-N)      Pin to the CPUs and bind the buffer to the NUMA node of the config's ibdev.\n";
+    std::cout << "    <schedule>            Pairing of RUs and BUs per phase (-L): linear (default) | random[:seed],\n";
+    std::cout << "                          reshuffled every round | radix:<units per leaf switch> | file:<path>, one\n";
+    std::cout << "                          line per phase with the BU slot of every RU slot in config order.\n";
+    std::cout << "    <optimized config>    Search the host order the linear shift performs best with on the measured\n";
+    std::cout << "                          links and write it as config (-O [min|round[,<switch radix>]:]<path>),\n";
+    std::cout << "                          min = best slowest phase, round = best round with barrier-bound phases.\n";
+    std::cout << "                          Searched between rounds once per logging interval, outside the timed phases.\n";
+    std::cout << "    <fault>               Inject a fault every other round, repeatable (-D <target>:<fault>), target\n";
+    std::cout << "                          rank=<n> | link=<ru id>-<bu id>, fault delay=<us> | jitter=<mean us> |\n";
+    std::cout << "                          periodic=<us>,<period ms>,<duty> | throttle=<Mbit/s>. Delays are per\n";
+    std::cout << "                          fragment; the throughput lost against the baseline rounds is logged.\n\n";
 }
 
 timespec diff(timespec start, timespec end)
@@ -94,13 +148,17 @@ bool directoryExists(const std::string &path)
  * @param rank Process rank (for printing)
  * @param commType Type of benchmark run
  * @param commArguments Args not related to benchmark type, passed to benchmark obj for parsing
+ * @param timelinePath Timeline export file, empty if tracing is disabled
+ * @param clockSync Whether clocks are synchronised against rank 0
+ * @param hardwareCounters Whether hardware counters are sampled
  *
  */
-void parseArguments(int argc, char **argv, int rank, CommunicationType &commType, std::vector<ArgumentEntry> &commArguments)
+void parseArguments(int argc, char **argv, int rank, CommunicationType &commType, std::vector<ArgumentEntry> &commArguments,
+                    std::string &timelinePath, bool &clockSync, bool &hardwareCounters)
 {
     int opt;
     bool nonblocking = false;
-    while ((opt = getopt(argc, argv, "m:i:b:w:sfvr:l:c:p:nh")) != -1)
+    while ((opt = getopt(argc, argv, "m:i:b:w:sfvr:l:c:p:t:d:z:R:T:e:k:F:S:u:q:Q:g:E:D:L:O:X:PaNMnyHh")) != -1)
     {
         switch (opt)
         {
@@ -143,6 +201,21 @@ void parseArguments(int argc, char **argv, int rank, CommunicationType &commType
         case 'n':
             nonblocking = true;
             break;
+        case 'E':
+            timelinePath = optarg;
+            break;
+        case 'y':
+            clockSync = true;
+            break;
+        case 'H':
+            hardwareCounters = true;
+            break;
+        case 'P':
+        case 'a':
+        case 'N':
+        case 'M':
+            commArguments.push_back({static_cast<char>(opt), ""});
+            break;
         case 'm':
         case 'i':
         case 'b':
@@ -151,6 +224,23 @@ void parseArguments(int argc, char **argv, int rank, CommunicationType &commType
         case 'p':
         case 'l':
         case 'c':
+        case 't':
+        case 'd':
+        case 'z':
+        case 'R':
+        case 'T':
+        case 'e':
+        case 'k':
+        case 'F':
+        case 'S':
+        case 'u':
+        case 'q':
+        case 'Q':
+        case 'g':
+        case 'D':
+        case 'L':
+        case 'O':
+        case 'X':
             commArguments.push_back({static_cast<char>(opt), optarg});
             break;
         case 'h':
@@ -219,6 +309,9 @@ int main(int argc, char **argv)
     char hostname[32];
     CommunicationType commType = COMM_UNDEFINED;
     std::vector<ArgumentEntry> commArguments;
+    std::string timelinePath;
+    bool clockSync = false;
+    bool hardwareCounters = false;
 
     std::unique_ptr<Benchmark> benchmark;
 
@@ -226,7 +319,8 @@ int main(int argc, char **argv)
     timespec runStartTime;
 
     // MPI setup
-    MPI_Init(&argc, &argv);
+    int threadSupport;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &threadSupport); // partitioned mode's readout thread makes no MPI calls
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
     gethostname(hostname, sizeof(hostname));
@@ -236,8 +330,12 @@ int main(int argc, char **argv)
 
     std::cout << "Rank " << rank << " initialised on " << host_str << std::endl;
 
+    CycleTimer::calibrate();
+    if (rank == 0)
+        std::cout << "Timer: " << CycleTimer::describe() << std::endl;
+
     // Benchmark object initialisation
-    parseArguments(argc, argv, rank, commType, commArguments);
+    parseArguments(argc, argv, rank, commType, commArguments, timelinePath, clockSync, hardwareCounters);
     if (commType == COMM_SCAN)
     {
         benchmark = std::make_unique<ScanBenchmark>(commArguments);
@@ -262,16 +360,52 @@ int main(int argc, char **argv)
 
     benchmark->setPhasesFilepath(createLogFilepath("phases", rank));
     benchmark->setAvgThroughputFilepath(createLogFilepath("avg_throughput", rank));
+    benchmark->setTrialsFilepath(createLogFilepath("trials", rank));
+    benchmark->setLatencyFilepath(createLogFilepath("latency_curve", rank));
+    benchmark->setIncastFilepath(createLogFilepath("incast", rank));
+    benchmark->setPhaseSwitchFilepath(createLogFilepath("phase_switch", rank));
+    benchmark->setRailsFilepath(createLogFilepath("stripe_channels", rank));
+    benchmark->setOneWayFilepath(createLogFilepath("one_way", rank));
+    benchmark->setBarrierSkewFilepath(createLogFilepath("barrier_skew", rank));
+    benchmark->setCountersFilepath(createLogFilepath("counters", rank));
+    benchmark->setCpuUsageFilepath(createLogFilepath("cpu_usage", rank));
+    benchmark->setPlacementFilepath(createLogFilepath("placement", rank));
+    benchmark->setFaultInjectionFilepath(createLogFilepath("fault_injection", rank));
+    benchmark->setRankTimingsFilepath(createLogFilepath("rank_timings", rank));
+    benchmark->setStragglersFilepath(createLogFilepath("stragglers", rank));
+    benchmark->setLinkMatrixFilepath(createLogFilepath("link_matrix", rank));
+    benchmark->setNodeLocalityFilepath(createLogFilepath("node_locality", rank));
+
+    if (hardwareCounters)
+        benchmark->enableHardwareCounters();
+
+    if (clockSync)
+        ClockSync::synchronise();
+
+    if (!timelinePath.empty())
+        Timeline::enable(timelinePath);
 
     // Run program
     clock_gettime(CLOCK_MONOTONIC, &runStartTime);
     benchmark->performWarmup();
 
+    // a second estimate gives the first drift, timers calibrated per process differ slightly in rate
+    if (clockSync)
+    {
+        ClockSync::synchronise();
+        std::cout << "Rank " << rank << " clock: " << ClockSync::describe() << std::endl;
+    }
+
     do
     {
         benchmark->run();
+        Timeline::exportEvents();
+
+        if (clockSync)
+            ClockSync::synchronise();
     } while (continueRun);
 
+    benchmark->releaseResources();
     MPI_Finalize();
 
     return 0;
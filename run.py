@@ -28,7 +28,9 @@ def parse_hostfile(hostfile_name):
 
 def start_run(host_list, config, mode, messages_per_phase=None,
               max_power=None, iterations=None, send_buffer_size=None, receive_buffer_size=None, warmup_iterations=None,
-              message_size=None, ru_buffer_bytes=None, bu_buffer_bytes=None, logging_interval=None, explanation=False, non_blocking=False):
+              message_size=None, ru_buffer_bytes=None, bu_buffer_bytes=None, logging_interval=None, trials=None,
+              size_distribution=None, size_correlation=None,
+              record_trace=None, replay_trace=None, event_rates=None, fan_in=None, fan_out=None, stripe_size=None, rails=None, partitions=None, readout_rate=None, pipelined=False, comm_scope=None, any_source=False, timeline=None, clock_sync=False, hardware_counters=False, nic_pinning=False, faults=None, schedule=None, optimized_config=None, shared_memory=False, transport=None, explanation=False, non_blocking=False):
     mpi_command = mpi_base_command.copy()
     mpi_command.extend(mpi_base_options)
 
@@ -47,6 +49,33 @@ def start_run(host_list, config, mode, messages_per_phase=None,
 
     if warmup_iterations is not None:
         run_options.extend(["-w", str(warmup_iterations)])
+    if trials is not None:
+        run_options.extend(["-t", str(trials)])
+    if record_trace is not None and mode != "scan":
+        run_options.extend(["-R", record_trace])
+    if comm_scope is not None and mode != "scan":
+        run_options.extend(["-g", comm_scope])
+    if any_source and mode != "scan":
+        run_options.extend(["-a"])
+    if nic_pinning and mode != "scan":
+        run_options.extend(["-N"])
+    if faults and mode != "scan":
+        for fault in faults:
+            run_options.extend(["-D", fault])
+    if schedule is not None and mode != "scan":
+        if schedule.startswith("file:"):
+            schedule = "file:" + os.path.abspath(schedule[len("file:"):])
+        run_options.extend(["-L", schedule])
+    if optimized_config is not None and mode != "scan":
+        run_options.extend(["-O", optimized_config])
+    if transport is not None:
+        run_options.extend(["-X", transport])
+    if timeline is not None:
+        run_options.extend(["-E", timeline])
+    if clock_sync:
+        run_options.extend(["-y"])
+    if hardware_counters:
+        run_options.extend(["-H"])
 
     if mode == "scan":
         run_options.extend(["-s"])
@@ -63,6 +92,24 @@ def start_run(host_list, config, mode, messages_per_phase=None,
         run_options.extend(["-f"])
         if message_size is not None:
             run_options.extend(["-m", str(message_size)])
+        if event_rates is not None:
+            run_options.extend(["-e", event_rates])
+        if fan_in is not None:
+            run_options.extend(["-k", str(fan_in)])
+        if fan_out is not None:
+            run_options.extend(["-F", str(fan_out)])
+        if stripe_size is not None:
+            run_options.extend(["-S", str(stripe_size)])
+        if rails is not None:
+            run_options.extend(["-u", str(rails)])
+        if partitions is not None:
+            run_options.extend(["-q", str(partitions)])
+        if readout_rate is not None:
+            run_options.extend(["-Q", str(readout_rate)])
+        if pipelined:
+            run_options.extend(["-P"])
+        if shared_memory:
+            run_options.extend(["-M"])
         if messages_per_phase is not None:
             run_options.extend(["-p", str(messages_per_phase)])
         if iterations is not None:
@@ -78,6 +125,12 @@ def start_run(host_list, config, mode, messages_per_phase=None,
         run_options.extend(["-v"])
         if message_size is not None:
             run_options.extend(["-m", str(message_size)])
+        if size_distribution is not None:
+            run_options.extend(["-d", size_distribution])
+        if size_correlation is not None:
+            run_options.extend(["-z", str(size_correlation)])
+        if replay_trace is not None:
+            run_options.extend(["-T", replay_trace])
         if messages_per_phase is not None:
             run_options.extend(["-p", str(messages_per_phase)])
         if iterations is not None:
@@ -95,18 +148,31 @@ def start_run(host_list, config, mode, messages_per_phase=None,
     ru_commands = shlex.split(f"{executable_path} -c {config} {' '.join(run_options)}")
     bu_commands = shlex.split(f"{executable_path} -c {config} {' '.join(run_options)}")
 
+    # striped mode: every process may use all devices of its host, UCX picks the device of every
+    # transfer (multi-rail), independent of the rail communicator the stripe travels on
+    host_devices = {}
     for (host, network_device) in host_info:
+        host_devices.setdefault(host, []).append(f"{network_device}:1")
+
+    # the benchmark pins itself with -N, otherwise hwloc-bind does it from outside
+    pin_externally = not (nic_pinning and mode != "scan")
+
+    for (host, network_device) in host_info:
+        ucx_devices = ",".join(host_devices[host]) if stripe_size is not None else f"{network_device}:1"
+
         # RU
         mpi_command.extend(shlex.split(f'--host {host}'))
-        mpi_command.extend(shlex.split(f"-x UCX_NET_DEVICES={network_device}:1"))
-        mpi_command.extend(shlex.split(f"{mpi_binding_options}{network_device}"))
+        mpi_command.extend(shlex.split(f"-x UCX_NET_DEVICES={ucx_devices}"))
+        if pin_externally:
+            mpi_command.extend(shlex.split(f"{mpi_binding_options}{network_device}"))
         mpi_command.extend(ru_commands)
         mpi_command.append(":")
 
         # BU
         mpi_command.extend(shlex.split(f'--host {host}'))
-        mpi_command.extend(shlex.split(f"-x UCX_NET_DEVICES={network_device}:1"))
-        mpi_command.extend(shlex.split(f"{mpi_binding_options}{network_device}"))
+        mpi_command.extend(shlex.split(f"-x UCX_NET_DEVICES={ucx_devices}"))
+        if pin_externally:
+            mpi_command.extend(shlex.split(f"{mpi_binding_options}{network_device}"))
         mpi_command.extend(bu_commands)
         mpi_command.append(":")
 
@@ -143,6 +209,13 @@ def main():
 
     parser.add_argument('-e', '--explanation', action='store_true', help='Print detailed usage explanation')
     parser.add_argument('-n', '--non-blocking', action='store_true', help='Enable nonblocking mode')
+    parser.add_argument('-F', '--fan-out', type=int, help='Fan-out mode (fixed): peers of every unit per phase')
+    parser.add_argument('-S', '--stripe-size', type=int,
+                        help='Striped mode (fixed): stripe bytes, processes see all devices of their host')
+    parser.add_argument('-u', '--rails', type=int, help='Number of rail communicators of the striped mode (fixed), devices are left to UCX')
+    parser.add_argument('-q', '--partitions', type=int, help='Partitioned mode (fixed): partitions per fragment')
+    parser.add_argument('-Q', '--readout-rate', type=float, help='Readout fill rate of the partitioned mode in Mbit/s (fixed)')
+    parser.add_argument('-P', '--pipelined', action='store_true', help='Pre-post the next phase\'s receives (fixed)')
     parser.add_argument('-mp', '--max-power', type=int, help='Set the maximum power of 2 for message sizes (scan)', default='1')
     parser.add_argument('-m', '--messages-per-phase', type=int, help='Set the number of messages to be sent in a phase (continuous)')
     parser.add_argument('-i', '--iterations', type=int, help='Specify the number of iterations')
@@ -154,6 +227,37 @@ def main():
     parser.add_argument('-w', '--warmup-iterations', type=int, help='Set the number of warmup iterations')
     parser.add_argument('-l', '--logging-interval', type=int, help='Set the interval for average throughput logging in seconds')
     parser.add_argument('-mv', '--message-size-variants', type=int, help='Set the number of message size variants')
+    parser.add_argument('-d', '--size-distribution', type=str,
+                        help='Fragment size distribution (variable): uniform:<min>,<max>, lognormal:<median>,<sigma>, '
+                        'bimodal:<weight>,<median low>,<median high>,<sigma> or histogram:<path>')
+    parser.add_argument('-z', '--size-correlation', type=float, help='Per-event fragment size correlation across RUs (variable)')
+    parser.add_argument('-R', '--record-trace', type=str, help='Record RU traffic to a trace file, {ru} is replaced by the RU id (continuous)')
+    parser.add_argument('-T', '--replay-trace', type=str, help='Replay a traffic trace file, {ru} is replaced by the RU id (variable)')
+    parser.add_argument('-er', '--event-rates', type=str,
+                        help='Paced open-loop mode (fixed): comma-separated fragment rates per RU in Hz, swept one per round')
+    parser.add_argument('-k', '--fan-in', type=int, help='Incast mode (fixed): number of RUs sending to one BU at once')
+    parser.add_argument('-g', '--comm-scope', type=str, choices=['world', 'phase', 'pair'],
+                        help='Dedicated communicators per phase or per RU/BU pair (continuous)')
+    parser.add_argument('-as', '--any-source', action='store_true', help='Receive with MPI_ANY_SOURCE (continuous)')
+    parser.add_argument('-t', '--trials', type=int, help='Repeat each measurement and report its variance')
+    parser.add_argument('-y', '--clock-sync', action='store_true',
+                        help='Synchronise clocks against rank 0, log one-way latency and barrier arrival skew')
+    parser.add_argument('-hc', '--hardware-counters', action='store_true',
+                        help='Log cycles, instructions, LLC and dTLB misses per phase / scan size')
+    parser.add_argument('-nic', '--nic-pinning', action='store_true',
+                        help='Let the benchmark pin itself next to the ibdev of config.json instead of hwloc-bind (continuous)')
+    parser.add_argument('-fi', '--fault', type=str, action='append',
+                        help='Inject a fault every other round, repeatable: rank=<n>|link=<ru id>-<bu id>:delay=<us>|'
+                        'jitter=<mean us>|periodic=<us>,<period ms>,<duty>|throttle=<Mbit/s> (continuous)')
+    parser.add_argument('-sch', '--schedule', type=str,
+                        help='RU/BU pairing per phase: linear|random[:seed]|radix:<units per leaf switch>|file:<path> (continuous)')
+    parser.add_argument('-oc', '--optimized-config', type=str,
+                        help='Write the host order best suited to the measured links as config: [min|round[,<switch radix>]:]<path> (continuous)')
+    parser.add_argument('-shm', '--shared-memory', action='store_true',
+                        help='Co-located RU/BU pairs hand fragments over in shared memory instead of MPI (fixed)')
+    parser.add_argument('-tr', '--transport', type=str, choices=['mpi', 'tcp', 'tcp-zerocopy', 'ucx', 'ucx-rma'],
+                        help='Move fragments over MPI, plain TCP sockets or UCP (UCX builds), blocking and non-blocking modes')
+    parser.add_argument('-tl', '--timeline', type=str, help='Export a Chrome trace / Perfetto timeline of all ranks to this file')
 
     args = parser.parse_args()
     hosts = parse_hostfile(args.hostfile)
@@ -172,6 +276,30 @@ def main():
         ru_buffer_bytes=args.ru_buffer_bytes,
         bu_buffer_bytes=args.bu_buffer_bytes,
         logging_interval=args.logging_interval,
+        trials=args.trials,
+        size_distribution=args.size_distribution,
+        size_correlation=args.size_correlation,
+        record_trace=args.record_trace,
+        replay_trace=args.replay_trace,
+        event_rates=args.event_rates,
+        fan_in=args.fan_in,
+        fan_out=args.fan_out,
+        stripe_size=args.stripe_size,
+        rails=args.rails,
+        partitions=args.partitions,
+        readout_rate=args.readout_rate,
+        pipelined=args.pipelined,
+        comm_scope=args.comm_scope,
+        any_source=args.any_source,
+        timeline=args.timeline,
+        clock_sync=args.clock_sync,
+        hardware_counters=args.hardware_counters,
+        nic_pinning=args.nic_pinning,
+        faults=args.fault,
+        schedule=args.schedule,
+        optimized_config=args.optimized_config,
+        shared_memory=args.shared_memory,
+        transport=args.transport,
         explanation=args.explanation,
         non_blocking=args.non_blocking
     )
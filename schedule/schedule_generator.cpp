@@ -0,0 +1,169 @@
+#include "schedule_generator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+std::size_t ScheduleGenerator::source(std::size_t bu, std::size_t phase) const
+{
+    for (std::size_t ru = 0; ru < m_units; ru++)
+    {
+        if (target(ru, phase) == bu)
+            return ru;
+    }
+    return m_units;
+}
+
+/**
+ * @brief Every phase is a permutation of the BU slots and source() inverts target()
+ */
+bool ScheduleGenerator::isValid() const
+{
+    for (std::size_t phase = 0; phase < m_units; phase++)
+    {
+        std::vector<bool> taken(m_units, false);
+        for (std::size_t ru = 0; ru < m_units; ru++)
+        {
+            std::size_t bu = target(ru, phase);
+            if (bu >= m_units || taken[bu] || source(bu, phase) != ru)
+                return false;
+            taken[bu] = true;
+        }
+    }
+    return true;
+}
+
+RandomSchedule::RandomSchedule(std::size_t units, unsigned seed)
+    : ScheduleGenerator(units), m_seed(seed)
+{
+    beginRound(0);
+}
+
+void RandomSchedule::beginRound(std::size_t round)
+{
+    std::mt19937 generator(m_seed + round);
+
+    m_row.resize(m_units);
+    m_column.resize(m_units);
+    std::iota(m_row.begin(), m_row.end(), 0);
+    std::iota(m_column.begin(), m_column.end(), 0);
+    std::shuffle(m_row.begin(), m_row.end(), generator);
+    std::shuffle(m_column.begin(), m_column.end(), generator);
+
+    m_rowInverse.resize(m_units);
+    m_columnInverse.resize(m_units);
+    for (std::size_t slot = 0; slot < m_units; slot++)
+    {
+        m_rowInverse[m_row[slot]] = slot;
+        m_columnInverse[m_column[slot]] = slot;
+    }
+}
+
+std::size_t RandomSchedule::target(std::size_t ru, std::size_t phase) const
+{
+    return m_column[(m_row[ru] + phase) % m_units];
+}
+
+std::size_t RandomSchedule::source(std::size_t bu, std::size_t phase) const
+{
+    return m_rowInverse[(m_columnInverse[bu] + m_units - phase % m_units) % m_units];
+}
+
+std::string RandomSchedule::describe() const
+{
+    return "random permutation per round, seed " + std::to_string(m_seed);
+}
+
+std::size_t RadixSchedule::target(std::size_t ru, std::size_t phase) const
+{
+    const std::size_t leaves = m_units / m_radix;
+    std::size_t leaf = (ru / m_radix + phase / m_radix) % leaves;
+    std::size_t port = (ru % m_radix + phase % m_radix) % m_radix;
+    return leaf * m_radix + port;
+}
+
+std::size_t RadixSchedule::source(std::size_t bu, std::size_t phase) const
+{
+    const std::size_t leaves = m_units / m_radix;
+    std::size_t leaf = (bu / m_radix + leaves - (phase / m_radix) % leaves) % leaves;
+    std::size_t port = (bu % m_radix + m_radix - phase % m_radix) % m_radix;
+    return leaf * m_radix + port;
+}
+
+std::string RadixSchedule::describe() const
+{
+    return "leaf-wise shift, " + std::to_string(m_radix) + " units per leaf switch";
+}
+
+/**
+ * @brief Read a schedule file, see FileSchedule
+ *
+ * @return nullptr if the file cannot be read or does not hold units phases of units slots
+ */
+std::unique_ptr<FileSchedule> FileSchedule::fromFile(const std::string &path, std::size_t units)
+{
+    std::ifstream file(path);
+    if (!file)
+        return nullptr;
+
+    std::vector<std::vector<std::size_t>> targets;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream iss(line);
+
+        std::vector<std::size_t> phase;
+        long slot;
+        while (iss >> slot)
+        {
+            if (slot < 0)
+                return nullptr;
+            phase.push_back(slot);
+        }
+
+        if (phase.size() != units)
+            return nullptr;
+        targets.push_back(phase);
+    }
+
+    if (targets.size() != units)
+        return nullptr;
+
+    return std::make_unique<FileSchedule>(units, path, targets);
+}
+
+/**
+ * @brief Schedule from its specification
+ *
+ * @param spec linear | random[:seed] | radix:<units per leaf> | file:<path>
+ * @param units RU (and BU) slots, phases of a round
+ * @param seed Used by random without an explicit seed, must be equal on all ranks
+ * @return nullptr if the specification is invalid or does not fit the unit count
+ */
+std::unique_ptr<ScheduleGenerator> createScheduleGenerator(const std::string &spec, std::size_t units, unsigned seed)
+{
+    std::string name = spec.substr(0, spec.find(':'));
+    std::string params = (spec.find(':') == std::string::npos) ? "" : spec.substr(spec.find(':') + 1);
+
+    std::unique_ptr<ScheduleGenerator> schedule;
+
+    if (name == "linear" && params.empty())
+        schedule = std::make_unique<LinearSchedule>(units);
+    else if (name == "random")
+        schedule = std::make_unique<RandomSchedule>(units, params.empty() ? seed : std::stoul(params));
+    else if (name == "radix" && std::atoi(params.c_str()) > 0 && units % std::atoi(params.c_str()) == 0)
+        schedule = std::make_unique<RadixSchedule>(units, std::atoi(params.c_str()));
+    else if (name == "file")
+        schedule = FileSchedule::fromFile(params, units);
+
+    if (!schedule || !schedule->isValid())
+        return nullptr;
+
+    return schedule;
+}
@@ -0,0 +1,124 @@
+#ifndef SCHEDULEGENERATOR_H
+#define SCHEDULEGENERATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Which BU every RU sends to in every phase
+ *
+ * Works on slots, the positions of the units in config.json (the opensm order), with
+ * n slots of each type and n phases. Every phase must be a permutation, so that each
+ * BU receives from exactly one RU. Dummy hosts keep their slot and simply idle.
+ */
+class ScheduleGenerator
+{
+public:
+    explicit ScheduleGenerator(std::size_t units) : m_units(units) {}
+    virtual ~ScheduleGenerator() {}
+
+    /**
+     * @brief Slot of the BU that RU slot ru sends to in phase
+     */
+    virtual std::size_t target(std::size_t ru, std::size_t phase) const = 0;
+
+    /**
+     * @brief Slot of the RU that BU slot bu receives from in phase
+     */
+    virtual std::size_t source(std::size_t bu, std::size_t phase) const;
+
+    virtual void beginRound(std::size_t /*round*/) {}
+    virtual bool changesPerRound() const { return false; }
+
+    virtual std::string describe() const = 0;
+
+    std::size_t getUnits() const { return m_units; }
+    bool isValid() const;
+
+protected:
+    std::size_t m_units;
+};
+
+/**
+ * @brief Phase p pairs RU i with BU i + p, the original rotation of Unit::ruShift / buShift
+ */
+class LinearSchedule : public ScheduleGenerator
+{
+public:
+    using ScheduleGenerator::ScheduleGenerator;
+
+    std::size_t target(std::size_t ru, std::size_t phase) const override { return (ru + phase) % m_units; }
+    std::size_t source(std::size_t bu, std::size_t phase) const override { return (bu + m_units - phase % m_units) % m_units; }
+    std::string describe() const override { return "linear shift"; }
+};
+
+/**
+ * @brief Linear shift between two random permutations of the slots, drawn again every round
+ *
+ * RU i sends to BU column[(row[i] + p) % n], so each round still pairs every RU with every BU once.
+ * All ranks must use the same seed.
+ */
+class RandomSchedule : public ScheduleGenerator
+{
+public:
+    RandomSchedule(std::size_t units, unsigned seed);
+
+    std::size_t target(std::size_t ru, std::size_t phase) const override;
+    std::size_t source(std::size_t bu, std::size_t phase) const override;
+    void beginRound(std::size_t round) override;
+    bool changesPerRound() const override { return true; }
+    std::string describe() const override;
+
+private:
+    unsigned m_seed;
+    std::vector<std::size_t> m_row, m_column;                 // slot permutations of the round
+    std::vector<std::size_t> m_rowInverse, m_columnInverse;
+};
+
+/**
+ * @brief Shift leaf by leaf, the slots of one leaf switch being consecutive
+ *
+ * In every phase the RUs of a leaf all send to the BUs of one leaf, which receives from
+ * no other, so leaf-to-leaf traffic is a permutation of the leaves and the uplinks of
+ * a leaf carry a single destination. The first radix phases stay within the leaf.
+ */
+class RadixSchedule : public ScheduleGenerator
+{
+public:
+    RadixSchedule(std::size_t units, std::size_t radix) : ScheduleGenerator(units), m_radix(radix) {}
+
+    std::size_t target(std::size_t ru, std::size_t phase) const override;
+    std::size_t source(std::size_t bu, std::size_t phase) const override;
+    std::string describe() const override;
+
+private:
+    std::size_t m_radix; // slots per leaf switch
+};
+
+/**
+ * @brief Schedule read from a text file
+ *
+ * One line per phase, holding the BU slot of RU slot 0, 1, ... separated by spaces or
+ * commas. Lines starting with '#' are comments.
+ */
+class FileSchedule : public ScheduleGenerator
+{
+public:
+    FileSchedule(std::size_t units, const std::string &path, const std::vector<std::vector<std::size_t>> &targets)
+        : ScheduleGenerator(units), m_path(path), m_targets(targets) {}
+
+    static std::unique_ptr<FileSchedule> fromFile(const std::string &path, std::size_t units);
+
+    std::size_t target(std::size_t ru, std::size_t phase) const override { return m_targets[phase][ru]; }
+    std::string describe() const override { return "file " + m_path; }
+
+private:
+    std::string m_path;
+    std::vector<std::vector<std::size_t>> m_targets; // per phase, per RU slot
+};
+
+std::unique_ptr<ScheduleGenerator> createScheduleGenerator(const std::string &spec, std::size_t units, unsigned seed);
+
+#endif // SCHEDULEGENERATOR_H
@@ -0,0 +1,202 @@
+#include "schedule_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <regex>
+
+ScheduleOptimizer::ScheduleOptimizer(const std::vector<double> &throughput, std::size_t units, ScheduleObjective objective, std::size_t radix)
+    : m_throughput(throughput), m_units(units), m_objective(objective), m_radix(radix)
+{
+    if (m_radix <= 1 || m_radix >= m_units || m_units % m_radix != 0) // a single leaf, all swaps allowed
+        m_radix = m_units;
+}
+
+/**
+ * @brief Expected throughput of the cluster in Mbit/s for a host order
+ *
+ * OBJECTIVE_MIN_PHASE: the sum of the phase's link throughputs, of the slowest phase.
+ * OBJECTIVE_ROUND: n links per phase running at the phase's slowest link, over the whole round.
+ */
+double ScheduleOptimizer::evaluate(const std::vector<std::size_t> &order) const
+{
+    double score = std::numeric_limits<double>::max();
+    double roundTime = 0.0; // per Mbit sent by every pair
+
+    for (std::size_t phase = 0; phase < m_units; phase++)
+    {
+        double sum = 0.0;
+        double slowest = std::numeric_limits<double>::max();
+        for (std::size_t slot = 0; slot < m_units; slot++)
+        {
+            double throughput = m_throughput[order[slot] * m_units + order[(slot + phase) % m_units]];
+            sum += throughput;
+            slowest = std::min(slowest, throughput);
+        }
+
+        score = std::min(score, sum);
+        roundTime += 1.0 / std::max(slowest, 1e-9);
+    }
+
+    if (m_objective == OBJECTIVE_ROUND)
+        return double(m_units) * m_units / roundTime;
+    return score;
+}
+
+/**
+ * @brief Simulated annealing over swaps, starting from the identity (the current config order)
+ *
+ * @param seed
+ * @return std::vector<std::size_t> Best order found, never worse than the identity
+ */
+std::vector<std::size_t> ScheduleOptimizer::optimize(unsigned seed) const
+{
+    std::vector<std::size_t> order(m_units);
+    std::iota(order.begin(), order.end(), 0);
+    if (m_units < 3) // every order gives the same phases
+        return order;
+
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<std::size_t> slots(0, m_units - 1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    const std::size_t leaves = m_units / m_radix;
+    const std::size_t moves = std::min<std::size_t>(200000, std::max<std::size_t>(200, evaluationBudget / (m_units * m_units)));
+
+    double score = evaluate(order);
+    std::vector<std::size_t> best = order;
+    double bestScore = score;
+
+    // from a tenth of the score down to a ten-thousandth, geometrically
+    const double startTemperature = 0.1 * score;
+    const double cooling = std::pow(1e-3, 1.0 / moves);
+    double temperature = startTemperature;
+
+    for (std::size_t move = 0; move < moves; move++, temperature *= cooling)
+    {
+        std::vector<std::size_t> candidate = order;
+
+        std::size_t a = slots(generator);
+        if (leaves > 1 && uniform(generator) < 0.5) // swap a's leaf with another one
+        {
+            std::size_t leafA = a / m_radix;
+            std::size_t leafB = (leafA + 1 + slots(generator) % (leaves - 1)) % leaves;
+            std::swap_ranges(candidate.begin() + leafA * m_radix, candidate.begin() + (leafA + 1) * m_radix,
+                             candidate.begin() + leafB * m_radix);
+        }
+        else // swap two hosts of a's leaf
+        {
+            std::size_t leafStart = (a / m_radix) * m_radix;
+            std::size_t b = leafStart + slots(generator) % m_radix;
+            if (a == b)
+                continue;
+            std::swap(candidate[a], candidate[b]);
+        }
+
+        double candidateScore = evaluate(candidate);
+        double delta = candidateScore - score;
+        if (delta >= 0 || uniform(generator) < std::exp(delta / std::max(temperature, 1e-12)))
+        {
+            order = candidate;
+            score = candidateScore;
+            if (score > bestScore)
+            {
+                best = order;
+                bestScore = score;
+            }
+        }
+    }
+
+    return best;
+}
+
+std::string ScheduleOptimizer::objectiveToString(ScheduleObjective objective)
+{
+    return (objective == OBJECTIVE_ROUND) ? "round" : "min-phase";
+}
+
+/**
+ * @brief Parse the -O specification
+ *
+ * @param spec [min|round[,<switch radix>]:]<output path>
+ * @return false if the objective or radix is malformed or the path is empty
+ */
+bool parseOptimizerSpec(const std::string &spec, std::string &path, ScheduleObjective &objective, std::size_t &radix)
+{
+    objective = OBJECTIVE_ROUND;
+    radix = 0;
+    path = spec;
+
+    static const std::regex prefix("^(min|round)(,([0-9]+))?:(.*)$");
+    std::smatch match;
+    if (std::regex_match(spec, match, prefix))
+    {
+        objective = (match[1] == "min") ? OBJECTIVE_MIN_PHASE : OBJECTIVE_ROUND;
+        if (match[3].matched)
+            radix = std::stoul(match[3]);
+        path = match[4];
+    }
+
+    return !path.empty();
+}
+
+/**
+ * @brief Write the config with its hosts reordered, host order[i] taking slot i
+ *
+ * The RU and BU entry of every host move together and the rankids are renumbered in the
+ * new order, so the linear shift of Unit::parseConfig realises the order. Ranks must be
+ * started in the same host order (hostfile of run.py).
+ *
+ * @return false if the config cannot be read, has another number of entries than the order
+ *         (dummies) or the output cannot be written
+ */
+bool writeConfigOrder(const std::string &configPath, const std::string &outputPath, const std::vector<std::size_t> &order)
+{
+    std::ifstream file(configPath);
+    if (!file)
+        return false;
+
+    std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // host entries hold no nested objects
+    std::vector<std::string> entries;
+    std::size_t index = json.find('[');
+    while (index != std::string::npos)
+    {
+        std::size_t entryStart = json.find('{', index);
+        std::size_t entryEnd = json.find('}', entryStart);
+        if (entryStart == std::string::npos || entryEnd == std::string::npos)
+            break;
+
+        entries.push_back(json.substr(entryStart, entryEnd - entryStart + 1));
+        index = entryEnd + 1;
+    }
+
+    if (entries.size() != 2 * order.size())
+        return false;
+
+    std::ofstream outputFile(outputPath, std::ios::trunc);
+    if (!outputFile.is_open())
+        return false;
+
+    static const std::regex rankid("(\"rankid\"\\s*:\\s*)-?[0-9]+");
+    outputFile << "{\n \"hosts\": [\n  ";
+    for (std::size_t slot = 0; slot < order.size(); slot++)
+    {
+        for (std::size_t type = 0; type < 2; type++) // RU, BU
+        {
+            const std::string &entry = entries[2 * order[slot] + type];
+            std::smatch match;
+            if (!std::regex_search(entry, match, rankid))
+                return false;
+            outputFile << match.prefix() << match[1] << 2 * slot + type << match.suffix();
+            outputFile << ((slot + 1 == order.size() && type == 1) ? "\n" : ",\n  ");
+        }
+    }
+    outputFile << " ]\n}\n";
+
+    return true;
+}
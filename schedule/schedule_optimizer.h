@@ -0,0 +1,48 @@
+#ifndef SCHEDULEOPTIMIZER_H
+#define SCHEDULEOPTIMIZER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+enum ScheduleObjective
+{
+    OBJECTIVE_MIN_PHASE, // maximise the slowest phase, pairs streaming at their own rate
+    OBJECTIVE_ROUND      // maximise the round, every phase lasting as long as its slowest pair
+};
+
+/**
+ * @brief Searches the host order for which the linear shift performs best on measured links
+ *
+ * Host k runs RU k and BU k, the order puts host order[i] into slot i, so phase p pairs
+ * RU order[i] with BU order[(i + p) % n]. Every order meets every pair once per round,
+ * only the grouping of the pairs into phases changes: OBJECTIVE_MIN_PHASE spreads weak
+ * links over the phases, OBJECTIVE_ROUND gathers them into as few phases as possible.
+ *
+ * With a switch radix, hosts are only swapped within their leaf switch or whole leaves
+ * with each other, which keeps the leaf-to-leaf traffic of every phase a shift as well.
+ * The search is simulated annealing from the current order, the best order seen is kept.
+ */
+class ScheduleOptimizer
+{
+public:
+    ScheduleOptimizer(const std::vector<double> &throughput, std::size_t units, ScheduleObjective objective, std::size_t radix);
+
+    std::vector<std::size_t> optimize(unsigned seed) const;
+    double evaluate(const std::vector<std::size_t> &order) const;
+
+    static std::string objectiveToString(ScheduleObjective objective);
+
+    static constexpr double evaluationBudget = 1e7; // link lookups per optimize(), bounds the time rank 0 spends
+
+private:
+    std::vector<double> m_throughput; // Mbit/s, RU-major
+    std::size_t m_units;
+    ScheduleObjective m_objective;
+    std::size_t m_radix;
+};
+
+bool parseOptimizerSpec(const std::string &spec, std::string &path, ScheduleObjective &objective, std::size_t &radix);
+bool writeConfigOrder(const std::string &configPath, const std::string &outputPath, const std::vector<std::size_t> &order);
+
+#endif // SCHEDULEOPTIMIZER_H
@@ -0,0 +1,80 @@
+#include "link_matrix.h"
+
+#include <fstream>
+#include <iomanip>
+
+void LinkMatrix::resize(std::size_t readoutUnits, std::size_t builderUnits)
+{
+    m_readoutUnits = readoutUnits;
+    m_builderUnits = builderUnits;
+    m_updates = 0;
+    m_cells.assign(readoutUnits * builderUnits, LinkCell());
+}
+
+/**
+ * @brief Fold one phase of a pair into its running means
+ */
+void LinkMatrix::update(std::size_t ru, std::size_t bu, double throughput, double rtt, std::size_t errors)
+{
+    if (ru >= m_readoutUnits || bu >= m_builderUnits)
+        return;
+
+    LinkCell &cell = m_cells[ru * m_builderUnits + bu];
+    cell.phases++;
+    cell.throughput += (throughput - cell.throughput) / cell.phases;
+    cell.rtt += (rtt - cell.rtt) / cell.phases;
+    cell.errors += errors;
+    m_updates++;
+}
+
+/**
+ * @brief Replace the file with the current matrix
+ *
+ * @param path
+ * @param description Written to the leading comment line
+ * @param ruIds Row labels
+ * @param buIds Column labels
+ * @return true if the file could be written
+ */
+bool LinkMatrix::write(const std::string &path, const std::string &description,
+                       const std::vector<std::string> &ruIds, const std::vector<std::string> &buIds) const
+{
+    std::ofstream outputFile(path, std::ios::trunc);
+    if (!outputFile.is_open())
+        return false;
+
+    outputFile << "# " << description << "\n"
+               << "metric,ru";
+    for (const std::string &id : buIds)
+        outputFile << "," << id;
+    outputFile << "\n";
+
+    const char *metrics[] = {"throughput", "rtt", "errors", "phases"};
+    for (const char *metric : metrics)
+    {
+        for (std::size_t ru = 0; ru < m_readoutUnits; ru++)
+        {
+            outputFile << metric << "," << ruIds[ru];
+            for (std::size_t bu = 0; bu < m_builderUnits; bu++)
+            {
+                const LinkCell &cell = at(ru, bu);
+                outputFile << ",";
+                if (cell.phases == 0) // never paired (dummies), left empty
+                    continue;
+
+                std::string name = metric;
+                if (name == "throughput")
+                    outputFile << std::fixed << std::setprecision(1) << cell.throughput;
+                else if (name == "rtt")
+                    outputFile << std::fixed << std::setprecision(8) << cell.rtt;
+                else if (name == "errors")
+                    outputFile << cell.errors;
+                else
+                    outputFile << cell.phases;
+            }
+            outputFile << "\n";
+        }
+    }
+
+    return true;
+}
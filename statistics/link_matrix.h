@@ -0,0 +1,42 @@
+#ifndef LINKMATRIX_H
+#define LINKMATRIX_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct LinkCell
+{
+    std::size_t phases = 0;  // phases the pair communicated in
+    double throughput = 0.0; // Mbit/s, mean over the phases
+    double rtt = 0.0;        // s per fragment, mean over the phases
+    std::size_t errors = 0;  // total
+};
+
+/**
+ * @brief Running RU x BU matrix of per-pair results, updated one phase at a time
+ *
+ * Dumped as CSV with one row per metric and RU and one column per BU, preceded by a
+ * "#" comment line, so a whole cluster fits on a screen and reads with
+ * pandas.read_csv(path, comment='#').
+ */
+class LinkMatrix
+{
+public:
+    void resize(std::size_t readoutUnits, std::size_t builderUnits);
+    bool empty() const { return m_updates == 0; }
+
+    void update(std::size_t ru, std::size_t bu, double throughput, double rtt, std::size_t errors);
+    const LinkCell &at(std::size_t ru, std::size_t bu) const { return m_cells[ru * m_builderUnits + bu]; }
+
+    bool write(const std::string &path, const std::string &description,
+               const std::vector<std::string> &ruIds, const std::vector<std::string> &buIds) const;
+
+private:
+    std::size_t m_readoutUnits = 0;
+    std::size_t m_builderUnits = 0;
+    std::size_t m_updates = 0;
+    std::vector<LinkCell> m_cells; // RU-major
+};
+
+#endif // LINKMATRIX_H
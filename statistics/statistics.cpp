@@ -0,0 +1,119 @@
+#include "statistics.h"
+
+/**
+ * @brief Two-sided 97.5% quantile of Student's t distribution
+ *
+ * Tabulated up to 30 degrees of freedom, normal approximation above.
+ *
+ * @param degreesOfFreedom
+ * @return double
+ */
+double tQuantile975(std::size_t degreesOfFreedom)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+    if (degreesOfFreedom == 0)
+        return 0.0;
+    if (degreesOfFreedom <= 30)
+        return table[degreesOfFreedom - 1];
+    return 1.960;
+}
+
+double median(std::vector<double> values)
+{
+    if (values.empty())
+        return 0.0;
+
+    std::size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    double upper = values[middle];
+
+    if (values.size() % 2 == 1)
+        return upper;
+
+    double lower = *std::max_element(values.begin(), values.begin() + middle);
+    return (lower + upper) / 2.0;
+}
+
+/**
+ * @brief Nearest-rank percentile
+ *
+ * @param values
+ * @param fraction Percentile as a fraction, e.g. 0.99
+ * @return double
+ */
+double percentile(std::vector<double> values, double fraction)
+{
+    if (values.empty())
+        return 0.0;
+
+    std::size_t rank = static_cast<std::size_t>(std::ceil(fraction * values.size()));
+    std::size_t idx = std::min(std::max<std::size_t>(rank, 1), values.size()) - 1;
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+double medianAbsoluteDeviation(const std::vector<double> &values, double center)
+{
+    std::vector<double> deviations(values.size());
+    std::transform(values.begin(), values.end(), deviations.begin(),
+                   [center](double value)
+                   { return std::fabs(value - center); });
+
+    return median(deviations);
+}
+
+/**
+ * @brief Summarise repeated measurements of the same quantity
+ *
+ * Samples whose modified z-score (0.6745 * |x - median| / MAD) exceeds the threshold
+ * are counted as outliers and excluded from mean, median, stddev and confidence interval.
+ * Below minimumSamples nothing is rejected: with 3 samples the MAD is the smaller of the
+ * two non-zero deviations, so ordinary noise would reject one and leave 2 for the interval.
+ *
+ * @param samples One value per trial (e.g. throughput)
+ * @param outlierThreshold Modified z-score above which a sample is rejected
+ * @param minimumSamples Sample count from which outliers are rejected
+ * @return TrialStatistics
+ */
+TrialStatistics computeTrialStatistics(const std::vector<double> &samples, double outlierThreshold, std::size_t minimumSamples)
+{
+    TrialStatistics stats;
+    stats.trials = samples.size();
+
+    if (samples.empty())
+        return stats;
+
+    double sampleMedian = median(samples);
+    double mad = (samples.size() >= minimumSamples) ? medianAbsoluteDeviation(samples, sampleMedian) : 0.0;
+
+    std::vector<double> accepted;
+    accepted.reserve(samples.size());
+    for (double sample : samples)
+    {
+        if (mad > 0.0 && 0.6745 * std::fabs(sample - sampleMedian) / mad > outlierThreshold)
+            stats.outliers++;
+        else
+            accepted.push_back(sample);
+    }
+
+    std::size_t n = accepted.size();
+    stats.mean = std::accumulate(accepted.begin(), accepted.end(), 0.0) / n;
+    stats.median = median(accepted);
+
+    if (n > 1)
+    {
+        double squares = 0.0;
+        for (double sample : accepted)
+            squares += (sample - stats.mean) * (sample - stats.mean);
+        stats.stddev = std::sqrt(squares / (n - 1));
+    }
+
+    double halfWidth = tQuantile975(n - 1) * stats.stddev / std::sqrt(static_cast<double>(n));
+    stats.ciLow = stats.mean - halfWidth;
+    stats.ciHigh = stats.mean + halfWidth;
+
+    return stats;
+}
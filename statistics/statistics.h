@@ -0,0 +1,27 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+struct TrialStatistics
+{
+    std::size_t trials = 0;   // samples taken
+    std::size_t outliers = 0; // samples rejected before computing the rest
+
+    double mean = 0.0;
+    double median = 0.0;
+    double stddev = 0.0;
+    double ciLow = 0.0; // 95% confidence interval of the mean
+    double ciHigh = 0.0;
+};
+
+double median(std::vector<double> values);
+double percentile(std::vector<double> values, double fraction);
+double medianAbsoluteDeviation(const std::vector<double> &values, double center);
+TrialStatistics computeTrialStatistics(const std::vector<double> &samples, double outlierThreshold = 3.5, std::size_t minimumSamples = 5);
+
+#endif // STATISTICS_H
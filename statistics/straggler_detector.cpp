@@ -0,0 +1,241 @@
+#include "straggler_detector.h"
+#include "statistics.h"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @brief Signed modified z-scores, positive above the median
+ *
+ * Falls back to the mean absolute deviation (scaled to match) when more than half
+ * of the values are identical and the MAD is 0.
+ */
+static std::vector<double> modifiedZScores(const std::vector<double> &values)
+{
+    double center = median(values);
+    double scale = medianAbsoluteDeviation(values, center) / 0.6745;
+
+    if (scale == 0.0)
+    {
+        double meanDeviation = 0.0;
+        for (double value : values)
+            meanDeviation += std::fabs(value - center) / values.size();
+        scale = 1.253314 * meanDeviation;
+    }
+
+    std::vector<double> scores(values.size(), 0.0);
+    if (scale > 0.0)
+    {
+        for (std::size_t i = 0; i < values.size(); i++)
+            scores[i] = (values[i] - center) / scale;
+    }
+    return scores;
+}
+
+/**
+ * @brief Let MPI advance the gather of the previous round, never blocks
+ */
+void StragglerDetector::progress()
+{
+    if (m_request == MPI_REQUEST_NULL)
+        return;
+
+    int done;
+    MPI_Test(&m_request, &done, MPI_STATUS_IGNORE);
+}
+
+/**
+ * @brief End of a round: finish the previous round's gather, analyse it on rank 0 and start this round's (collective)
+ *
+ * @param host Configured hostname of this rank, only sent the first time
+ * @param device Configured ibdev of this rank, only sent the first time
+ * @return true on rank 0 if a round was analysed
+ */
+bool StragglerDetector::submit(const std::string &host, const std::string &device)
+{
+    if (m_comm == MPI_COMM_NULL)
+    {
+        MPI_Comm_dup(MPI_COMM_WORLD, &m_comm);
+        MPI_Comm_rank(m_comm, &m_rank);
+        MPI_Comm_size(m_comm, &m_size);
+        gatherLabels(host + " " + device);
+    }
+
+    bool analysed = false;
+    if (m_pending)
+    {
+        MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+        if (m_rank == 0)
+        {
+            analyse();
+            analysed = true;
+        }
+    }
+
+    m_sending.swap(m_round);
+    m_round.clear();
+    m_phases = m_sending.size();
+
+    const int bytes = m_phases * sizeof(PhaseTiming);
+    m_received.resize(m_rank == 0 ? m_phases * m_size : 0);
+    MPI_Igather(m_sending.data(), bytes, MPI_BYTE, m_received.data(), bytes, MPI_BYTE, 0, m_comm, &m_request);
+    m_pending = true;
+
+    return analysed;
+}
+
+void StragglerDetector::gatherLabels(const std::string &label)
+{
+    const int length = 64;
+
+    char local[length] = {};
+    std::strncpy(local, label.c_str(), length - 1);
+
+    std::vector<char> labels(m_rank == 0 ? length * m_size : 0);
+    MPI_Gather(local, length, MPI_CHAR, labels.data(), length, MPI_CHAR, 0, m_comm);
+
+    if (m_rank != 0)
+        return;
+
+    m_rankScores.resize(m_size);
+    for (int rank = 0; rank < m_size; rank++)
+    {
+        std::string entry(labels.data() + rank * length);
+        m_hosts.push_back(entry.substr(0, entry.find(' ')));
+        m_devices.push_back(entry.substr(entry.find(' ') + 1));
+        m_rankScores[rank].rank = rank;
+    }
+}
+
+/**
+ * @brief Score every rank of every phase of the gathered round against the others of its role
+ */
+void StragglerDetector::analyse()
+{
+    m_roundTimings.clear();
+
+    for (std::size_t phase = 0; phase < m_phases; phase++)
+    {
+        std::vector<RankTiming> phaseTimings;
+        for (int rank = 0; rank < m_size; rank++)
+            phaseTimings.push_back({rank, m_received[rank * m_phases + phase], 0.0, 0.0});
+        std::vector<bool> scored(m_size, false); // enough peers of the same role to compare with
+        std::size_t roleSizes[2] = {0, 0};      // ranks of each role that moved data
+
+        for (int role = 0; role <= 1; role++)
+        {
+            std::vector<std::size_t> members;
+            std::vector<double> timePerByte, negativeWait;
+            for (std::size_t i = 0; i < phaseTimings.size(); i++)
+            {
+                const PhaseTiming &timing = phaseTimings[i].timing;
+                if (timing.role != role || timing.bytes <= 0)
+                    continue;
+
+                members.push_back(i);
+                timePerByte.push_back(timing.busyTime / timing.bytes);
+                negativeWait.push_back(-timing.barrierWait);
+            }
+
+            roleSizes[role] = members.size();
+            if (members.size() < minimumPeers)
+                continue;
+
+            std::vector<double> timeScores = modifiedZScores(timePerByte);
+            std::vector<double> waitScores = modifiedZScores(negativeWait);
+            for (std::size_t i = 0; i < members.size(); i++)
+            {
+                phaseTimings[members[i]].timeScore = timeScores[i];
+                phaseTimings[members[i]].waitScore = waitScores[i];
+                scored[members[i]] = true;
+            }
+        }
+
+        // a slow peer slows both ends, so a rank counts as flagged whenever its link is; only
+        // the culprit is flagged in every phase, its peers change from phase to phase
+        for (const RankTiming &rankTiming : phaseTimings)
+        {
+            if (!scored[rankTiming.rank])
+                continue;
+
+            double worst = std::max(rankTiming.timeScore, rankTiming.waitScore);
+            if (rankTiming.timing.peer >= 0)
+                worst = std::max(worst, phaseTimings[static_cast<int>(rankTiming.timing.peer)].timeScore);
+
+            StragglerSuspect &score = m_rankScores[rankTiming.rank];
+            score.observed++;
+            score.peers = std::max(score.peers, roleSizes[rankTiming.timing.role == 0 ? 1 : 0]);
+            if (worst > scoreThreshold)
+                score.flagged++;
+            score.maxScore = std::max(score.maxScore, worst);
+        }
+
+        // links are scored from the RU end, by the slower end's time per byte
+        for (const RankTiming &ruTiming : phaseTimings)
+        {
+            if (ruTiming.timing.role != 0 || ruTiming.timing.peer < 0 || !scored[ruTiming.rank])
+                continue;
+
+            int buRank = static_cast<int>(ruTiming.timing.peer);
+            double worst = std::max(ruTiming.timeScore, phaseTimings[buRank].timeScore);
+
+            StragglerSuspect &score = m_linkScores[{ruTiming.rank, buRank}];
+            score.rank = ruTiming.rank;
+            score.peer = buRank;
+            score.observed++;
+            if (worst > scoreThreshold)
+                score.flagged++;
+            score.maxScore = std::max(score.maxScore, worst);
+        }
+
+        m_roundTimings.insert(m_roundTimings.end(), phaseTimings.begin(), phaseTimings.end());
+    }
+}
+
+static bool moreSuspicious(const StragglerSuspect &a, const StragglerSuspect &b)
+{
+    if (a.ratio() != b.ratio())
+        return a.ratio() > b.ratio();
+    return a.maxScore > b.maxScore;
+}
+
+/**
+ * @brief Ranks flagged in at least suspectRatio and more than 1/peers of their phases so far, most suspicious first
+ */
+std::vector<StragglerSuspect> StragglerDetector::hostSuspects() const
+{
+    std::vector<StragglerSuspect> suspects;
+    for (const StragglerSuspect &score : m_rankScores)
+    {
+        // a single slow peer flags a healthy rank in exactly 1/peers of its phases
+        if (score.flagged >= 2 && score.ratio() >= suspectRatio && score.flagged * score.peers > score.observed)
+            suspects.push_back(score);
+    }
+
+    std::sort(suspects.begin(), suspects.end(), moreSuspicious);
+    return suspects;
+}
+
+/**
+ * @brief Links flagged in at least suspectRatio of their rounds whose ends are not suspects themselves, most suspicious first
+ */
+std::vector<StragglerSuspect> StragglerDetector::linkSuspects() const
+{
+    std::vector<StragglerSuspect> hosts = hostSuspects();
+    auto isHostSuspect = [&hosts](int rank)
+    {
+        return std::any_of(hosts.begin(), hosts.end(), [rank](const StragglerSuspect &host)
+                           { return host.rank == rank; });
+    };
+
+    std::vector<StragglerSuspect> suspects;
+    for (const auto &link : m_linkScores)
+    {
+        const StragglerSuspect &score = link.second;
+        if (score.flagged >= 2 && score.ratio() >= suspectRatio && !isHostSuspect(score.rank) && !isHostSuspect(score.peer))
+            suspects.push_back(score);
+    }
+
+    std::sort(suspects.begin(), suspects.end(), moreSuspicious);
+    return suspects;
+}
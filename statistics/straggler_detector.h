@@ -0,0 +1,99 @@
+#ifndef STRAGGLERDETECTOR_H
+#define STRAGGLERDETECTOR_H
+
+#include <mpi.h>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief What one rank saw of one phase, gathered to rank 0 as raw bytes
+ */
+struct PhaseTiming
+{
+    double phase = 0;
+    double role = -1; // 0 = RU, 1 = BU, -1 = idle (dummy peer)
+    double peer = -1; // rank of the peer
+    double start = 0; // s, after the phase barrier, rank 0's timebase with clock sync, local otherwise
+    double end = 0;   // s, after the last batch
+    double barrierWait = 0; // s spent in the phase barrier
+    double busyTime = 0;    // s spent in communication
+    double bytes = 0;       // sent (RU) or received (BU)
+};
+
+struct RankTiming
+{
+    int rank;
+    PhaseTiming timing;
+    double timeScore; // modified z-score of busy time per byte among the ranks of the same role in the phase
+    double waitScore; // modified z-score of the barrier wait, negated: arriving last scores high
+};
+
+struct StragglerSuspect
+{
+    int rank;
+    int peer = -1; // links only, BU rank
+    std::size_t flagged = 0;
+    std::size_t observed = 0;
+    std::size_t peers = 0; // ranks only, most ranks of the other role met in one round
+    double maxScore = 0.0;
+
+    double ratio() const { return observed > 0 ? double(flagged) / observed : 0.0; }
+};
+
+/**
+ * @brief Flags ranks and links that are consistently slower than their peers
+ *
+ * Every rank records one PhaseTiming per phase. At the end of a round the timings are
+ * handed to an MPI_Igather on a private communicator, which is only completed at the end
+ * of the next round, so ranks never wait for it. Rank 0 then scores every phase with the
+ * modified z-score (0.6745 * |x - median| / MAD) against the other ranks of the same role
+ * and accumulates how often each rank and each RU -> BU link was flagged.
+ *
+ * A rank flagged in a good share of its phases is slow whoever its peer is (host or HCA),
+ * a link flagged in a good share of its rounds with neither end suspect is the cable or port.
+ * A slow rank drags each of its peers down in the one phase they meet, so a rank is only a
+ * suspect above 1/peers of its phases flagged, the share one slow peer alone accounts for.
+ */
+class StragglerDetector
+{
+public:
+    void record(const PhaseTiming &timing) { m_round.push_back(timing); }
+    void progress();
+    bool submit(const std::string &host, const std::string &device);
+
+    const std::vector<RankTiming> &getRoundTimings() const { return m_roundTimings; }
+    std::vector<StragglerSuspect> hostSuspects() const;
+    std::vector<StragglerSuspect> linkSuspects() const;
+    const std::string &getHost(int rank) const { return m_hosts[rank]; }
+    const std::string &getDevice(int rank) const { return m_devices[rank]; }
+
+    static constexpr double scoreThreshold = 3.5;   // modified z-score above which a phase is flagged
+    static constexpr double suspectRatio = 1.0 / 3;   // flagged fraction of phases (ranks, and above 1/peers) or rounds (links) of a suspect
+    static constexpr std::size_t minimumPeers = 3;  // ranks per role a phase needs to be scored
+
+private:
+    void gatherLabels(const std::string &label);
+    void analyse();
+
+    MPI_Comm m_comm = MPI_COMM_NULL;
+    int m_rank = 0;
+    int m_size = 1;
+
+    std::vector<PhaseTiming> m_round;    // this round, not handed over yet
+    std::vector<PhaseTiming> m_sending;  // previous round, in flight
+    std::vector<PhaseTiming> m_received; // rank 0: all ranks' previous round, rank-major
+    MPI_Request m_request = MPI_REQUEST_NULL;
+    bool m_pending = false; // a gather was started, m_request is reset once MPI_Test sees it complete
+    std::size_t m_phases = 0;
+
+    std::vector<std::string> m_hosts; // rank 0: configured hostname and ibdev of every rank
+    std::vector<std::string> m_devices;
+    std::vector<RankTiming> m_roundTimings;
+    std::vector<StragglerSuspect> m_rankScores;
+    std::map<std::pair<int, int>, StragglerSuspect> m_linkScores;
+};
+
+#endif // STRAGGLERDETECTOR_H
@@ -0,0 +1,97 @@
+#include "clock_sync.h"
+
+#include <limits>
+#include <sstream>
+#include <iomanip>
+
+MPI_Comm ClockSync::s_comm = MPI_COMM_NULL;
+std::vector<ClockSync::Estimate> ClockSync::s_estimates;
+double ClockSync::s_drift = 0.0;
+
+/**
+ * @brief Measure the offset of every rank's clock to rank 0 (collective)
+ *
+ * Rank 0 serves the other ranks one after another, so the exchanges do not
+ * compete with each other. Meant to run at startup and between rounds.
+ *
+ * @param rounds Ping-pongs per rank, the one with the smallest round trip is kept
+ */
+void ClockSync::synchronise(int rounds)
+{
+    const int tag = 0;
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (s_comm == MPI_COMM_NULL)
+        MPI_Comm_dup(MPI_COMM_WORLD, &s_comm);
+
+    Estimate estimate = {CycleTimer::toSeconds(CycleTimer::now()), 0.0, 0.0};
+
+    if (rank == 0)
+    {
+        for (int peer = 1; peer < size; peer++)
+        {
+            for (int round = 0; round < rounds; round++)
+            {
+                MPI_Recv(nullptr, 0, MPI_BYTE, peer, tag, s_comm, MPI_STATUS_IGNORE);
+                double reference = CycleTimer::toSeconds(CycleTimer::now());
+                MPI_Send(&reference, 1, MPI_DOUBLE, peer, tag, s_comm);
+            }
+        }
+    }
+    else
+    {
+        estimate.roundTrip = std::numeric_limits<double>::max();
+
+        for (int round = 0; round < rounds; round++)
+        {
+            double reference;
+            double sent = CycleTimer::toSeconds(CycleTimer::now());
+            MPI_Send(nullptr, 0, MPI_BYTE, 0, tag, s_comm);
+            MPI_Recv(&reference, 1, MPI_DOUBLE, 0, tag, s_comm, MPI_STATUS_IGNORE);
+            double received = CycleTimer::toSeconds(CycleTimer::now());
+
+            // queueing only ever lengthens the round trip, so the shortest one is the most symmetric
+            if (received - sent < estimate.roundTrip)
+            {
+                estimate.localTime = (sent + received) / 2;
+                estimate.offset = reference - estimate.localTime;
+                estimate.roundTrip = received - sent;
+            }
+        }
+    }
+
+    s_estimates.push_back(estimate);
+    if (s_estimates.size() > s_historyLength)
+        s_estimates.erase(s_estimates.begin());
+
+    // least-squares slope of offset over local time
+    const std::size_t n = s_estimates.size();
+    double meanTime = 0.0, meanOffset = 0.0;
+    for (const Estimate &sample : s_estimates)
+    {
+        meanTime += sample.localTime / n;
+        meanOffset += sample.offset / n;
+    }
+
+    double covariance = 0.0, variance = 0.0;
+    for (const Estimate &sample : s_estimates)
+    {
+        covariance += (sample.localTime - meanTime) * (sample.offset - meanOffset);
+        variance += (sample.localTime - meanTime) * (sample.localTime - meanTime);
+    }
+
+    s_drift = (variance > 0.0) ? covariance / variance : 0.0;
+}
+
+std::string ClockSync::describe()
+{
+    std::ostringstream description;
+    description << std::fixed << std::setprecision(2)
+                << "offset " << getOffset() * 1e6 << " us"
+                << ", round trip " << getRoundTrip() * 1e6 << " us"
+                << ", drift " << s_drift * 1e6 << " ppm";
+    return description.str();
+}
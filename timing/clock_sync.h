@@ -0,0 +1,58 @@
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <mpi.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cycle_timer.h"
+
+/**
+ * @brief Estimate of this rank's clock against rank 0, for timestamps comparable across ranks
+ *
+ * Each synchronise() runs ping-pongs with rank 0 and keeps the one with the smallest
+ * round trip, whose offset error is bounded by half of it. Drift is the slope of the
+ * offsets of the last estimates, so global times stay accurate between synchronisations.
+ */
+class ClockSync
+{
+public:
+    static void synchronise(int rounds = 32);
+    static bool isEnabled() { return !s_estimates.empty(); }
+
+    /**
+     * @brief Seconds in rank 0's timebase
+     */
+    static double toGlobal(uint64_t ticks)
+    {
+        double local = CycleTimer::toSeconds(ticks);
+        const Estimate &last = s_estimates.back();
+        return local + last.offset + s_drift * (local - last.localTime);
+    }
+
+    static double now() { return toGlobal(CycleTimer::now()); }
+
+    static double getOffset() { return s_estimates.back().offset; }
+    static double getRoundTrip() { return s_estimates.back().roundTrip; }
+    static double getDrift() { return s_drift; }
+
+    static std::string describe();
+
+private:
+    struct Estimate
+    {
+        double localTime; // s, midpoint of the selected ping-pong
+        double offset;    // s, rank 0 minus local
+        double roundTrip; // s, of the selected ping-pong
+    };
+
+    static const std::size_t s_historyLength = 16; // estimates the drift is fitted over
+
+    static MPI_Comm s_comm; // private duplicate, never matches benchmark traffic
+    static std::vector<Estimate> s_estimates;
+    static double s_drift;
+};
+
+#endif // CLOCKSYNC_H
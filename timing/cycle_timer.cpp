@@ -0,0 +1,81 @@
+#include "cycle_timer.h"
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#ifdef CYCLE_TIMER_HAS_TSC
+#include <cpuid.h>
+#endif
+
+bool CycleTimer::s_useTsc = false;
+bool CycleTimer::s_useRdtscp = false;
+double CycleTimer::s_ticksPerNs = 1.0;
+double CycleTimer::s_overheadNs = 0.0;
+double CycleTimer::s_resolutionNs = 0.0;
+
+uint64_t monotonicNs()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000000ULL + time.tv_nsec;
+}
+
+/**
+ * @brief Select the time source and measure its rate, overhead and resolution
+ *
+ * The TSC is used only if CPUID reports it invariant (constant rate across P/C-states),
+ * its rate is measured against CLOCK_MONOTONIC over 20 ms.
+ */
+void CycleTimer::calibrate()
+{
+#ifdef CYCLE_TIMER_HAS_TSC
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1 << 8)))
+    {
+        s_useTsc = true;
+        s_useRdtscp = __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) && (edx & (1 << 27));
+
+        uint64_t startNs = monotonicNs();
+        uint64_t startTicks = now();
+        while (monotonicNs() - startNs < 20000000)
+            ;
+        uint64_t endTicks = now();
+        uint64_t endNs = monotonicNs();
+
+        s_ticksPerNs = static_cast<double>(endTicks - startTicks) / (endNs - startNs);
+    }
+#endif
+
+    const int samples = 10000;
+
+    uint64_t start = now();
+    for (int i = 0; i < samples; i++)
+        now();
+    s_overheadNs = toSeconds(now() - start) * 1e9 / samples;
+
+    // smallest step the time source can report
+    uint64_t smallest = UINT64_MAX;
+    for (int i = 0; i < samples; i++)
+    {
+        uint64_t first = now(), second = now();
+        while (second == first)
+            second = now();
+        smallest = std::min(smallest, second - first);
+    }
+    s_resolutionNs = toSeconds(smallest) * 1e9;
+}
+
+std::string CycleTimer::describe()
+{
+    std::ostringstream description;
+    description << std::fixed << std::setprecision(2);
+
+    if (s_useTsc)
+        description << (s_useRdtscp ? "invariant TSC (rdtscp), " : "invariant TSC (rdtsc), ") << s_ticksPerNs << " GHz";
+    else
+        description << "clock_gettime(CLOCK_MONOTONIC)";
+
+    description << ", overhead " << s_overheadNs << " ns, resolution " << s_resolutionNs << " ns";
+    return description.str();
+}
@@ -0,0 +1,56 @@
+#ifndef CYCLETIMER_H
+#define CYCLETIMER_H
+
+#include <cstdint>
+#include <string>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLE_TIMER_HAS_TSC 1
+#endif
+
+/**
+ * @brief Low-overhead monotonic timestamps for hot loops
+ *
+ * Backed by the invariant TSC when the CPU has one, by CLOCK_MONOTONIC otherwise.
+ * Timestamps are opaque ticks, only differences converted with toSeconds() are meaningful.
+ * calibrate() must run once per process before the first timestamp is taken.
+ */
+class CycleTimer
+{
+public:
+    static void calibrate();
+
+    static uint64_t now()
+    {
+#ifdef CYCLE_TIMER_HAS_TSC
+        if (s_useTsc)
+        {
+            unsigned int aux;
+            return s_useRdtscp ? __rdtscp(&aux) : __rdtsc();
+        }
+#endif
+        timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return time.tv_sec * 1000000000ULL + time.tv_nsec;
+    }
+
+    static double toSeconds(uint64_t ticks) { return ticks / (s_ticksPerNs * 1e9); }
+
+    static bool usesTsc() { return s_useTsc; }
+    static double getFrequencyGHz() { return s_ticksPerNs; }
+    static double getOverheadNs() { return s_overheadNs; }
+    static double getResolutionNs() { return s_resolutionNs; }
+
+    static std::string describe();
+
+private:
+    static bool s_useTsc;
+    static bool s_useRdtscp;
+    static double s_ticksPerNs;
+    static double s_overheadNs;
+    static double s_resolutionNs;
+};
+
+#endif // CYCLETIMER_H
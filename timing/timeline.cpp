@@ -0,0 +1,159 @@
+#include "timeline.h"
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+bool Timeline::s_enabled = false;
+std::string Timeline::s_path;
+uint64_t Timeline::s_epoch = 0;
+bool Timeline::s_exported = false;
+
+std::mutex Timeline::s_buffersMutex;
+std::vector<std::unique_ptr<TimelineBuffer>> Timeline::s_buffers;
+
+/**
+ * @brief Start recording on all ranks (collective)
+ *
+ * Timestamps are relative to leaving a barrier, so ranks share a time origin
+ * up to the barrier exit skew, or exactly when clocks are synchronised (see exportEvents()).
+ *
+ * @param path Chrome trace JSON written by rank 0
+ */
+void Timeline::enable(const std::string &path)
+{
+    s_path = path;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    s_epoch = CycleTimer::now();
+    s_enabled = true;
+}
+
+TimelineBuffer *Timeline::threadBuffer()
+{
+    // released for reuse when the thread exits
+    struct Handle
+    {
+        TimelineBuffer *buffer = nullptr;
+        ~Handle()
+        {
+            if (buffer)
+                buffer->inUse.store(false, std::memory_order_release);
+        }
+    };
+    thread_local Handle handle;
+
+    if (handle.buffer)
+        return handle.buffer;
+
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    for (const auto &buffer : s_buffers)
+    {
+        bool expected = false;
+        if (buffer->inUse.compare_exchange_strong(expected, true))
+        {
+            handle.buffer = buffer.get();
+            return handle.buffer;
+        }
+    }
+
+    s_buffers.push_back(std::make_unique<TimelineBuffer>(s_buffers.size()));
+    s_buffers.back()->inUse.store(true);
+    handle.buffer = s_buffers.back().get();
+    return handle.buffer;
+}
+
+/**
+ * @brief Drain the events recorded since the last export and merge them on rank 0 (collective)
+ *
+ * Rank 0 appends to a JSON array that is never closed, which the Chrome trace format
+ * allows, so the file can be loaded in chrome://tracing or Perfetto while the run continues.
+ * With ClockSync enabled, timestamps are converted to rank 0's timebase first.
+ */
+void Timeline::exportEvents()
+{
+    if (!s_enabled)
+        return;
+
+    TimelineScope scope("timeline export");
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // time origin: rank 0's epoch in the global timebase, or each rank's own epoch
+    bool global = ClockSync::isEnabled();
+    double origin = global ? ClockSync::toGlobal(s_epoch) : CycleTimer::toSeconds(s_epoch);
+    if (global)
+        MPI_Bcast(&origin, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    auto timestamp = [&](uint64_t ticks)
+    {
+        return (global ? ClockSync::toGlobal(ticks) : CycleTimer::toSeconds(ticks)) - origin;
+    };
+
+    std::ostringstream events;
+    events.precision(3);
+    events << std::fixed;
+
+    std::size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        for (const auto &buffer : s_buffers)
+        {
+            uint32_t tid = buffer->getTid();
+            auto writeEvent = [&](const TimelineEvent &event)
+            {
+                events << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":" << tid
+                       << ",\"ts\":" << timestamp(event.begin) * 1e6
+                       << ",\"dur\":" << CycleTimer::toSeconds(event.end - event.begin) * 1e6;
+                if (event.arg >= 0)
+                    events << ",\"args\":{\"value\":" << event.arg << "}";
+                events << "}";
+            };
+
+            buffer->drain(writeEvent);
+            dropped += buffer->takeDropped();
+        }
+    }
+
+    if (dropped > 0)
+        std::cerr << "Rank " << rank << ": timeline buffer full, " << dropped << " events dropped" << std::endl;
+
+    std::string local = events.str();
+    int localBytes = local.size();
+
+    std::vector<int> counts(size), displacements(size);
+    MPI_Gather(&localBytes, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    std::string merged;
+    if (rank == 0)
+    {
+        for (int r = 1; r < size; r++)
+            displacements[r] = displacements[r - 1] + counts[r - 1];
+        merged.resize(displacements[size - 1] + counts[size - 1]);
+    }
+
+    MPI_Gatherv(local.data(), localBytes, MPI_CHAR, &merged[0], counts.data(), displacements.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    if (rank != 0)
+        return;
+
+    FILE *file = std::fopen(s_path.c_str(), s_exported ? "a" : "w");
+    if (!file)
+    {
+        std::cerr << "Failed to open file: " << s_path << std::endl;
+        return;
+    }
+
+    if (!s_exported)
+    {
+        std::fputs("[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"rank 0\"}}", file);
+        for (int r = 1; r < size; r++)
+            std::fprintf(file, ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"rank %d\"}}", r, r);
+        s_exported = true;
+    }
+
+    std::fwrite(merged.data(), 1, merged.size(), file);
+    std::fclose(file);
+}
@@ -0,0 +1,125 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <mpi.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cycle_timer.h"
+#include "clock_sync.h"
+
+struct TimelineEvent
+{
+    const char *name; // string literal, never copied
+    uint64_t begin;   // CycleTimer ticks
+    uint64_t end;
+    int64_t arg; // shown as args.value, -1 for none
+};
+
+/**
+ * @brief Single-producer single-consumer ring of timeline events
+ *
+ * The owning thread pushes, the exporting thread drains. When the ring is full
+ * new events are dropped and counted rather than blocking the producer.
+ */
+class TimelineBuffer
+{
+public:
+    explicit TimelineBuffer(uint32_t tid) : m_tid(tid), m_events(m_capacity) {}
+
+    void push(const TimelineEvent &event)
+    {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_capacity)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        m_events[head % m_capacity] = event;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    template <typename Function>
+    void drain(Function function)
+    {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t head = m_head.load(std::memory_order_acquire);
+
+        for (; tail < head; tail++)
+            function(m_events[tail % m_capacity]);
+
+        m_tail.store(tail, std::memory_order_release);
+    }
+
+    uint32_t getTid() const { return m_tid; }
+    std::size_t takeDropped() { return m_dropped.exchange(0, std::memory_order_relaxed); }
+
+    std::atomic<bool> inUse{false}; // claimed by a live thread
+
+private:
+    const uint32_t m_tid;
+    const std::size_t m_capacity = 1 << 16;
+    std::vector<TimelineEvent> m_events;
+
+    std::atomic<std::size_t> m_head{0};
+    std::atomic<std::size_t> m_tail{0};
+    std::atomic<std::size_t> m_dropped{0};
+};
+
+/**
+ * @brief Per-rank timeline of begin/end events, merged into a Chrome trace on rank 0
+ *
+ * Disabled unless enable() was called, recording then costs one branch. Every thread
+ * records into its own ring buffer; buffers of finished threads are reused by new ones.
+ */
+class Timeline
+{
+public:
+    static void enable(const std::string &path);
+    static bool isEnabled() { return s_enabled; }
+
+    static void record(const char *name, uint64_t begin, int64_t arg = -1)
+    {
+        if (!s_enabled)
+            return;
+        threadBuffer()->push({name, begin, CycleTimer::now(), arg});
+    }
+
+    static void exportEvents();
+
+private:
+    static TimelineBuffer *threadBuffer();
+
+    static bool s_enabled;
+    static std::string s_path;
+    static uint64_t s_epoch; // ticks at the exit of a common barrier
+    static bool s_exported;
+
+    static std::mutex s_buffersMutex;
+    static std::vector<std::unique_ptr<TimelineBuffer>> s_buffers;
+};
+
+/**
+ * @brief Record the lifetime of a scope as one timeline event
+ */
+class TimelineScope
+{
+public:
+    explicit TimelineScope(const char *name, int64_t arg = -1)
+        : m_name(name), m_arg(arg), m_begin(Timeline::isEnabled() ? CycleTimer::now() : 0) {}
+
+    ~TimelineScope() { Timeline::record(m_name, m_begin, m_arg); }
+
+private:
+    const char *m_name;
+    int64_t m_arg;
+    uint64_t m_begin;
+};
+
+#endif // TIMELINE_H
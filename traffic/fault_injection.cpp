@@ -0,0 +1,198 @@
+#include "fault_injection.h"
+
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+#include "../timing/cycle_timer.h"
+
+/**
+ * @brief Parse a fault specification, see FaultSpec
+ *
+ * @param spec e.g. "rank=3:delay=200" or "link=A-B:throttle=5000"
+ * @param fault Filled on success
+ * @return true if the specification is valid
+ */
+bool parseFaultSpec(const std::string &spec, FaultSpec &fault)
+{
+    std::size_t separator = spec.find(':');
+    if (separator == std::string::npos)
+        return false;
+
+    std::string target = spec.substr(0, separator);
+    std::string type = spec.substr(separator + 1, spec.find('=', separator) - separator - 1);
+    std::string params = (spec.find('=', separator) == std::string::npos) ? "" : spec.substr(spec.find('=', separator) + 1);
+
+    if (target.rfind("rank=", 0) == 0)
+    {
+        fault.rank = std::atoi(target.c_str() + 5);
+        if (fault.rank < 0 || target.size() == 5)
+            return false;
+    }
+    else if (target.rfind("link=", 0) == 0 && target.find('-') != std::string::npos)
+    {
+        fault.ruId = target.substr(5, target.find('-') - 5);
+        fault.buId = target.substr(target.find('-') + 1);
+        if (fault.ruId.empty() || fault.buId.empty())
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    std::vector<double> values;
+    std::istringstream iss(params);
+    std::string token;
+    while (std::getline(iss, token, ','))
+        values.push_back(std::atof(token.c_str()));
+
+    if (type == "delay" && values.size() == 1 && values[0] > 0)
+    {
+        fault.type = FAULT_DELAY;
+        fault.delay = values[0] * 1e-6;
+    }
+    else if (type == "jitter" && values.size() == 1 && values[0] > 0)
+    {
+        fault.type = FAULT_JITTER;
+        fault.delay = values[0] * 1e-6;
+    }
+    else if (type == "periodic" && values.size() == 3 && values[0] > 0 && values[1] > 0 && values[2] > 0 && values[2] <= 1)
+    {
+        fault.type = FAULT_PERIODIC;
+        fault.delay = values[0] * 1e-6;
+        fault.period = values[1] * 1e-3;
+        fault.duty = values[2];
+    }
+    else if (type == "throttle" && values.size() == 1 && values[0] > 0)
+    {
+        fault.type = FAULT_THROTTLE;
+        fault.rate = values[0];
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+std::string FaultSpec::describe() const
+{
+    std::ostringstream description;
+    description << std::fixed << std::setprecision(1);
+
+    if (rank >= 0)
+        description << "rank " << rank << ": ";
+    else
+        description << "link " << ruId << "->" << buId << ": ";
+
+    switch (type)
+    {
+    case FAULT_DELAY:
+        description << "delay " << delay * 1e6 << " us/fragment";
+        break;
+    case FAULT_JITTER:
+        description << "jitter mean " << delay * 1e6 << " us/fragment";
+        break;
+    case FAULT_PERIODIC:
+        description << "delay " << delay * 1e6 << " us/fragment for " << duty * 100 << "% of every " << period * 1e3 << " ms";
+        break;
+    case FAULT_THROTTLE:
+        description << "throttle " << rate << " Mbit/s";
+        break;
+    }
+
+    return description.str();
+}
+
+/**
+ * @brief Pick the faults that apply to this rank while it is paired with ruId -> buId
+ */
+void FaultInjector::selectPhase(int rank, bool isRu, const std::string &ruId, const std::string &buId)
+{
+    m_selected.clear();
+
+    for (const FaultSpec &fault : m_faults)
+    {
+        if (fault.rank == rank || (fault.rank < 0 && isRu && fault.ruId == ruId && fault.buId == buId))
+            m_selected.push_back(&fault);
+    }
+}
+
+/**
+ * @brief Stall before a batch by the delay of all selected faults
+ *
+ * @param fragments Fragments in the batch, delays are per fragment
+ */
+void FaultInjector::delayBatch(std::size_t fragments)
+{
+    if (!isSelected())
+        return;
+
+    double seconds = 0.0;
+    for (const FaultSpec *fault : m_selected)
+    {
+        if (fault->type == FAULT_DELAY)
+        {
+            seconds += fault->delay * fragments;
+        }
+        else if (fault->type == FAULT_JITTER)
+        {
+            // sum of per-fragment exponential delays
+            std::gamma_distribution<double> distribution(static_cast<double>(fragments), fault->delay);
+            seconds += distribution(m_generator);
+        }
+        else if (fault->type == FAULT_PERIODIC)
+        {
+            double time = CycleTimer::toSeconds(CycleTimer::now());
+            if (std::fmod(time, fault->period) < fault->duty * fault->period)
+                seconds += fault->delay * fragments;
+        }
+    }
+
+    spin(seconds);
+}
+
+/**
+ * @brief Stretch a finished batch to the lowest selected throttle rate
+ *
+ * @param startTicks Start of the batch (CycleTimer ticks)
+ * @param bytes Bytes the batch moved
+ */
+void FaultInjector::throttleBatch(uint64_t startTicks, std::size_t bytes)
+{
+    if (!isSelected())
+        return;
+
+    double rate = 0.0;
+    for (const FaultSpec *fault : m_selected)
+    {
+        if (fault->type == FAULT_THROTTLE && (rate == 0.0 || fault->rate < rate))
+            rate = fault->rate;
+    }
+
+    if (rate == 0.0)
+        return;
+
+    double elapsed = CycleTimer::toSeconds(CycleTimer::now() - startTicks);
+    spin(bytes * 8.0 / (rate * 1e6) - elapsed);
+}
+
+std::string FaultInjector::describe() const
+{
+    std::string description;
+    for (const FaultSpec &fault : m_faults)
+        description += std::string(description.empty() ? "" : "; ") + fault.describe();
+    return description;
+}
+
+void FaultInjector::spin(double seconds)
+{
+    if (seconds <= 0.0)
+        return;
+
+    uint64_t start = CycleTimer::now();
+    while (CycleTimer::toSeconds(CycleTimer::now() - start) < seconds)
+        ;
+}
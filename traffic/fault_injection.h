@@ -0,0 +1,77 @@
+#ifndef FAULTINJECTION_H
+#define FAULTINJECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+enum FaultType
+{
+    FAULT_DELAY,    // fixed delay per fragment
+    FAULT_JITTER,   // exponentially distributed delay per fragment
+    FAULT_PERIODIC, // fixed delay per fragment during the "on" part of every period
+    FAULT_THROTTLE  // bandwidth cap
+};
+
+/**
+ * @brief One injected fault, either on every pair a rank takes part in or on one RU -> BU link
+ *
+ * Spec: <target>:<fault>, with target rank=<n> or link=<ru id>-<bu id> and fault one of
+ *   delay=<us>                              fixed delay per fragment
+ *   jitter=<us>                             random delay per fragment, exponential with this mean
+ *   periodic=<us>,<period ms>,<duty cycle>  delay per fragment in the first duty * period of every period
+ *   throttle=<Mbit/s>                       cap on the bytes a batch may move per second
+ */
+struct FaultSpec
+{
+    int rank = -1; // rank target, -1 for a link target
+    std::string ruId, buId;
+
+    FaultType type = FAULT_DELAY;
+    double delay = 0.0;  // s per fragment (mean for jitter)
+    double period = 0.0; // s, periodic only
+    double duty = 0.0;   // fraction of the period the delay is applied, periodic only
+    double rate = 0.0;   // Mbit/s, throttle only
+
+    std::string describe() const;
+};
+
+bool parseFaultSpec(const std::string &spec, FaultSpec &fault);
+
+/**
+ * @brief Slows down the batches of the selected ranks and links
+ *
+ * Delays stall the calling rank before a batch is handed to MPI, the throttle stretches
+ * a finished batch to the capped rate. Both spin on the CPU like a busy straggler would.
+ * A rank target applies to both roles of the rank, a link target to the sending RU only.
+ */
+class FaultInjector
+{
+public:
+    void add(const FaultSpec &fault) { m_faults.push_back(fault); }
+    bool empty() const { return m_faults.empty(); }
+
+    void setActive(bool active) { m_active = active; }
+    bool isActive() const { return m_active; }
+
+    void selectPhase(int rank, bool isRu, const std::string &ruId, const std::string &buId);
+    bool isSelected() const { return m_active && !m_selected.empty(); }
+
+    void delayBatch(std::size_t fragments);
+    void throttleBatch(uint64_t startTicks, std::size_t bytes);
+
+    std::string describe() const;
+
+private:
+    static void spin(double seconds);
+
+    std::vector<FaultSpec> m_faults;
+    std::vector<const FaultSpec *> m_selected; // faults applying to this rank in the current phase
+    bool m_active = false;
+
+    std::mt19937 m_generator{std::random_device{}()};
+};
+
+#endif // FAULTINJECTION_H
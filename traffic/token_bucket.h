@@ -0,0 +1,66 @@
+#ifndef TOKENBUCKET_H
+#define TOKENBUCKET_H
+
+#include <cstdint>
+#include <algorithm>
+#include <time.h>
+
+/**
+ * @brief Token bucket pacing the readout thread of the partitioned mode (-Q)
+ *
+ * Tokens accrue at the configured rate up to the bucket depth, every partition filled
+ * consumes one. Tokens beyond the depth are dropped, so while the readout waits for the
+ * next fragment to be requested it does not save up credit to fill that one at once.
+ * acquire() returns the token's nominal time i / rate.
+ */
+class TokenBucket
+{
+public:
+    TokenBucket(double rate, double depth = 1.0) : m_intervalNs(1e9 / rate), m_depth(depth) {}
+
+    void start()
+    {
+        clock_gettime(CLOCK_MONOTONIC, &m_startTime);
+        m_tokens = 1.0;
+        m_lastRefillNs = 0;
+        m_issued = 0;
+    }
+
+    /**
+     * @brief Busy-wait for a token
+     *
+     * @return uint64_t Nominal emission time of this fragment in ns since start()
+     */
+    uint64_t acquire()
+    {
+        while (m_tokens < 1.0)
+        {
+            uint64_t nowNs = elapsedNs();
+            m_tokens = std::min(m_depth, m_tokens + (nowNs - m_lastRefillNs) / m_intervalNs);
+            m_lastRefillNs = nowNs;
+        }
+
+        m_tokens -= 1.0;
+        return static_cast<uint64_t>(m_issued++ * m_intervalNs);
+    }
+
+    uint64_t elapsedNs() const
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (now.tv_sec - m_startTime.tv_sec) * 1000000000ULL + now.tv_nsec - m_startTime.tv_nsec;
+    }
+
+    double getIntervalNs() const { return m_intervalNs; }
+
+private:
+    double m_intervalNs;
+    double m_depth;
+
+    double m_tokens = 1.0;
+    uint64_t m_lastRefillNs = 0;
+    uint64_t m_issued = 0;
+    timespec m_startTime;
+};
+
+#endif // TOKENBUCKET_H
@@ -0,0 +1,181 @@
+#include "traffic_trace.h"
+
+/**
+ * @brief Resolve the trace file of one RU, the same way for recording and replay
+ *
+ * "{ru}" in the path is replaced by the RU id. Without it the RU id is appended
+ * ("path.<id>") when there is more than one RU, so RUs neither overwrite each
+ * other's recordings nor replay another RU's trace.
+ *
+ * @param path
+ * @param ruId
+ * @param ruCount
+ * @return std::string
+ */
+std::string tracePathForUnit(const std::string &path, const std::string &ruId, std::size_t ruCount)
+{
+    std::string resolved = path;
+    std::size_t placeholder = resolved.find("{ru}");
+    if (placeholder != std::string::npos)
+        resolved.replace(placeholder, 4, ruId);
+    else if (ruCount > 1)
+        resolved += "." + ruId;
+    return resolved;
+}
+
+TraceWriter::TraceWriter(const std::string &path, uint32_t ru, uint32_t ruCount) : m_ru(ru)
+{
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file)
+    {
+        std::cerr << "Failed to open trace file for writing: " << path << std::endl;
+        return;
+    }
+
+    TraceFileHeader header;
+    std::memcpy(header.magic, traceMagic, sizeof(header.magic));
+    header.version = traceVersion;
+    header.ruCount = ruCount;
+    header.recordCount = 0;
+    std::fwrite(&header, sizeof(header), 1, m_file);
+
+    m_records.reserve(m_flushThreshold);
+}
+
+TraceWriter::~TraceWriter()
+{
+    if (!m_file)
+        return;
+
+    flush();
+
+    // patch the final record count into the header
+    std::fseek(m_file, offsetof(TraceFileHeader, recordCount), SEEK_SET);
+    std::fwrite(&m_recordCount, sizeof(m_recordCount), 1, m_file);
+    std::fclose(m_file);
+}
+
+void TraceWriter::flush()
+{
+    if (!m_file || m_records.empty())
+        return;
+
+    std::fwrite(m_records.data(), sizeof(TraceRecord), m_records.size(), m_file);
+    std::fflush(m_file);
+    m_recordCount += m_records.size();
+    m_records.clear();
+}
+
+/**
+ * @brief Map a trace file for streaming replay
+ *
+ * The file is mapped read-only and consumed sequentially, pages that were already
+ * replayed are dropped so traces larger than memory can be used.
+ *
+ * @param path
+ * @param ru RU index of the replaying unit, mapped onto the trace's RUs modulo their count
+ */
+TraceReader::TraceReader(const std::string &path, uint32_t ru)
+{
+    m_fd = open(path.c_str(), O_RDONLY);
+    if (m_fd < 0)
+    {
+        std::cerr << "Failed to open trace file: " << path << std::endl;
+        return;
+    }
+
+    struct stat info;
+    if (fstat(m_fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(TraceFileHeader) + sizeof(TraceRecord))
+    {
+        std::cerr << "Trace file too short: " << path << std::endl;
+        release();
+        return;
+    }
+
+    m_mappingBytes = info.st_size;
+    m_mapping = mmap(nullptr, m_mappingBytes, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (m_mapping == MAP_FAILED)
+    {
+        m_mapping = nullptr;
+        std::cerr << "Failed to map trace file: " << path << std::endl;
+        release();
+        return;
+    }
+    madvise(m_mapping, m_mappingBytes, MADV_SEQUENTIAL);
+
+    const TraceFileHeader *header = static_cast<const TraceFileHeader *>(m_mapping);
+    if (std::memcmp(header->magic, traceMagic, sizeof(traceMagic)) != 0 || header->version != traceVersion)
+    {
+        std::cerr << "Not a trace file: " << path << std::endl;
+        release();
+        return;
+    }
+
+    std::size_t available = (m_mappingBytes - sizeof(TraceFileHeader)) / sizeof(TraceRecord);
+    m_recordCount = (header->recordCount == 0) ? available : std::min<std::size_t>(header->recordCount, available);
+    m_ruCount = std::max<uint32_t>(header->ruCount, 1);
+    m_ru = ru % m_ruCount;
+
+    m_records = reinterpret_cast<const TraceRecord *>(static_cast<const char *>(m_mapping) + sizeof(TraceFileHeader));
+
+    // make sure next() can always find a record
+    while (m_cursor < m_recordCount && m_records[m_cursor].ru != m_ru)
+        m_cursor++;
+
+    if (m_cursor == m_recordCount)
+    {
+        std::cerr << "Trace file has no records for RU " << m_ru << ": " << path << std::endl;
+        release();
+    }
+}
+
+TraceReader::~TraceReader()
+{
+    release();
+}
+
+void TraceReader::release()
+{
+    if (m_mapping)
+        munmap(m_mapping, m_mappingBytes);
+    if (m_fd >= 0)
+        close(m_fd);
+
+    m_mapping = nullptr;
+    m_records = nullptr;
+    m_fd = -1;
+}
+
+/**
+ * @brief Next fragment of this RU, wrapping around at the end of the trace
+ *
+ * @return TraceRecord
+ */
+TraceRecord TraceReader::next()
+{
+    while (m_records[m_cursor].ru != m_ru)
+    {
+        if (++m_cursor == m_recordCount)
+            m_cursor = 0;
+    }
+
+    TraceRecord record = m_records[m_cursor];
+
+    if (++m_cursor == m_recordCount)
+    {
+        m_cursor = 0;
+        m_releasedUpTo = 0;
+    }
+
+    // drop replayed pages in 64 MiB steps
+    const std::size_t releaseStep = (64 << 20) / sizeof(TraceRecord);
+    if (m_cursor >= m_releasedUpTo + releaseStep)
+    {
+        const long pageSize = sysconf(_SC_PAGESIZE);
+        std::size_t endByte = sizeof(TraceFileHeader) + m_cursor * sizeof(TraceRecord);
+        madvise(m_mapping, endByte - endByte % pageSize, MADV_DONTNEED);
+        m_releasedUpTo = m_cursor;
+    }
+
+    return record;
+}
@@ -0,0 +1,114 @@
+#ifndef TRAFFICTRACE_H
+#define TRAFFICTRACE_H
+
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * Trace file layout (little endian, no padding):
+ *
+ *   TraceFileHeader                   24 B
+ *   TraceRecord[recordCount]          16 B each
+ *
+ * Records of several RUs may be interleaved in one file, each RU replays only its own.
+ * interArrivalNs is the time since the previous fragment of the same RU.
+ * A recordCount of 0 means "until end of file" (writer did not finish).
+ */
+const char traceMagic[8] = {'E', 'B', 'T', 'R', 'A', 'C', 'E', '1'};
+const uint32_t traceVersion = 1;
+
+struct TraceFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t ruCount;
+    uint64_t recordCount;
+};
+
+struct TraceRecord
+{
+    uint32_t ru;
+    uint32_t size;
+    uint64_t interArrivalNs;
+};
+
+static_assert(sizeof(TraceFileHeader) == 24, "unexpected trace header layout");
+static_assert(sizeof(TraceRecord) == 16, "unexpected trace record layout");
+
+std::string tracePathForUnit(const std::string &path, const std::string &ruId, std::size_t ruCount);
+
+class TraceWriter
+{
+public:
+    TraceWriter(const std::string &path, uint32_t ru, uint32_t ruCount);
+    ~TraceWriter();
+
+    bool isOpen() const { return m_file != nullptr; }
+
+    /**
+     * @brief Record a fragment handed to MPI now
+     */
+    void record(std::size_t size)
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        uint64_t nowNs = now.tv_sec * 1000000000ULL + now.tv_nsec;
+
+        m_records.push_back({m_ru, static_cast<uint32_t>(size), m_lastNs ? nowNs - m_lastNs : 0});
+        m_lastNs = nowNs;
+
+        if (m_records.size() == m_flushThreshold)
+            flush();
+    }
+
+    void flush();
+
+private:
+    FILE *m_file = nullptr;
+    uint32_t m_ru;
+    uint64_t m_recordCount = 0;
+    uint64_t m_lastNs = 0;
+
+    const std::size_t m_flushThreshold = 4096;
+    std::vector<TraceRecord> m_records;
+};
+
+class TraceReader
+{
+public:
+    TraceReader(const std::string &path, uint32_t ru);
+    ~TraceReader();
+
+    bool isOpen() const { return m_records != nullptr; }
+    uint32_t getRuCount() const { return m_ruCount; }
+    std::size_t getRecordCount() const { return m_recordCount; }
+
+    TraceRecord next();
+
+private:
+    void release();
+
+    int m_fd = -1;
+    void *m_mapping = nullptr;
+    std::size_t m_mappingBytes = 0;
+
+    const TraceRecord *m_records = nullptr;
+    std::size_t m_recordCount = 0;
+    std::size_t m_cursor = 0;
+    std::size_t m_releasedUpTo = 0;
+
+    uint32_t m_ru;
+    uint32_t m_ruCount = 1;
+};
+
+#endif // TRAFFICTRACE_H
@@ -0,0 +1,94 @@
+#include "nic_locality.h"
+
+#include <fstream>
+#include <sstream>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/**
+ * @brief Read NUMA node and local CPUs of an RDMA device, or of a network interface of that name
+ *
+ * @param device e.g. "mlx5_0" (/sys/class/infiniband) or "eth0" (/sys/class/net)
+ * @return NicLocality Empty fields for what sysfs does not provide
+ */
+NicLocality readNicLocality(const std::string &device)
+{
+    NicLocality locality;
+    locality.device = device;
+
+    for (const char *deviceClass : {"infiniband", "net"})
+    {
+        std::string base = std::string("/sys/class/") + deviceClass + "/" + device + "/device/";
+
+        std::ifstream numaFile(base + "numa_node");
+        if (!(numaFile >> locality.numaNode))
+            continue;
+
+        std::ifstream cpuFile(base + "local_cpulist");
+        std::getline(cpuFile, locality.cpuList);
+        break;
+    }
+
+    return locality;
+}
+
+std::vector<int> parseCpuList(const std::string &list)
+{
+    std::vector<int> cpus;
+    std::stringstream ranges(list);
+    std::string range;
+
+    while (std::getline(ranges, range, ','))
+    {
+        if (range.empty())
+            continue;
+
+        std::size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+/**
+ * @brief Restrict the calling thread (and threads it creates later) to the given CPUs
+ */
+bool pinThreadToCpus(const std::vector<int> &cpus)
+{
+    if (cpus.empty())
+        return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+    {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    }
+
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+/**
+ * @brief Bind a page-aligned range to one NUMA node (mbind with MPOL_BIND)
+ *
+ * Called through the syscall so that libnuma is not needed.
+ */
+bool bindMemoryToNode(void *address, std::size_t bytes, int node)
+{
+    const int mpolBind = 2;             // MPOL_BIND
+    const unsigned mpolMfMove = 1 << 1; // MPOL_MF_MOVE, pages already touched are migrated
+
+    if (node < 0)
+        return false;
+
+    std::vector<unsigned long> nodeMask(node / (8 * sizeof(unsigned long)) + 1, 0);
+    nodeMask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+
+    return syscall(SYS_mbind, address, bytes, mpolBind, nodeMask.data(), nodeMask.size() * 8 * sizeof(unsigned long) + 1, mpolMfMove) == 0;
+}
@@ -0,0 +1,24 @@
+#ifndef NICLOCALITY_H
+#define NICLOCALITY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Where a network device sits in the host topology, as reported by sysfs
+ */
+struct NicLocality
+{
+    std::string device;
+    int numaNode = -1;   // -1 if unknown or the device has no NUMA affinity
+    std::string cpuList; // CPUs local to the device, sysfs list format ("0-15,32-47")
+};
+
+NicLocality readNicLocality(const std::string &device);
+std::vector<int> parseCpuList(const std::string &list);
+
+bool pinThreadToCpus(const std::vector<int> &cpus);
+bool bindMemoryToNode(void *address, std::size_t bytes, int node);
+
+#endif // NICLOCALITY_H
@@ -29,6 +29,10 @@ void Unit::allocateMemory()
         std::exit(1);
     }
 
+    // bind before the first touch so that pages are allocated on the node directly
+    if (m_numaNode >= 0)
+        m_memoryBound = bindMemoryToNode(mem, m_bufferBytes, m_numaNode);
+
     m_buffer = static_cast<int8_t *>(mem);
     std::fill(m_buffer, m_buffer + m_bufferBytes, 0);
 
@@ -92,6 +96,20 @@ void Unit::parseConfig()
             }
         }
 
+        if (rankId == m_rank)
+            m_configHostname = hostname;
+
+        // network device of this rank, "ibdev" of the same host entry
+        size_t entryStart = json.rfind("{", hostnameStart);
+        size_t entryEnd = json.find("}", hostnameStart);
+        size_t ibdevStart = json.find("\"ibdev\"", entryStart);
+        if (rankId == m_rank && ibdevStart != std::string::npos && ibdevStart < entryEnd)
+        {
+            size_t ibdevValueStart = json.find("\"", json.find(":", ibdevStart)) + 1;
+            size_t ibdevValueEnd = json.find("\"", ibdevValueStart);
+            m_networkDevice = json.substr(ibdevValueStart, ibdevValueEnd - ibdevValueStart);
+        }
+
         if (((m_type == BU) && (nodeInd % 2 == 0))     // append RUs to BU shift vector
             || ((m_type == RU) && (nodeInd % 2 == 1))) // append BUs to RU shift vector
         {
@@ -112,16 +130,31 @@ void Unit::parseConfig()
 void Unit::ruShift(int idx)
 {
     parseConfig();
+    m_order = m_shift;
+    m_index = idx;
     std::rotate(m_shift.begin(), m_shift.begin() + idx, m_shift.end());
 }
 
 void Unit::buShift(int idx)
 {
     parseConfig();
+    m_order = m_shift;
+    m_index = idx;
 
     std::vector<int> vec_r(m_shift.size());
     std::copy(m_shift.rbegin(), m_shift.rend(), vec_r.begin());
 
     std::copy(vec_r.begin(), vec_r.end(), m_shift.begin());
     std::rotate(m_shift.begin(), m_shift.end() - 1 - idx, m_shift.end());
-}
\ No newline at end of file
+}
+/**
+ * @brief Replace the shift by the pairs of a schedule, for the slot given to ruShift / buShift
+ */
+void Unit::applySchedule(const ScheduleGenerator &schedule)
+{
+    for (std::size_t phase = 0; phase < m_shift.size(); phase++)
+    {
+        std::size_t slot = (m_type == RU) ? schedule.target(m_index, phase) : schedule.source(m_index, phase);
+        m_shift[phase] = m_order[slot];
+    }
+}
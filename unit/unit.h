@@ -15,6 +15,9 @@
 #include <numeric>
 #include <mpi.h>
 
+#include "nic_locality.h"
+#include "../schedule/schedule_generator.h"
+
 enum UnitType
 {
     UNDEFINED,
@@ -46,9 +49,18 @@ public:
     void setUnitType(UnitType type) { m_type = type; }
 
     void setConfigPath(const std::string &path) { m_configPath = path; }
+    const std::string getConfigPath() const { return m_configPath; }
+
+    const std::string getConfigHostname() const { return m_configHostname; }
+    const std::string getNetworkDevice() const { return m_networkDevice; }
+
+    int getNumaNode() const { return m_numaNode; }
+    void setNumaNode(int node) { m_numaNode = node; } // buffer is bound to it by allocateMemory()
+    bool isMemoryBound() const { return m_memoryBound; }
 
     void ruShift(int idx);
     void buShift(int idx);
+    void applySchedule(const ScheduleGenerator &schedule);
     int getPair(int phase) { return m_shift[phase]; }    
     std::string getPairHost(int idx) { return m_hostnames[idx]; }
 
@@ -66,9 +78,16 @@ protected:
     int8_t *m_buffer;
 
     std::vector<int> m_shift;       
+    std::vector<int> m_order; // opposite-type indices in config order, m_shift before the rotation
+    int m_index = 0;          // slot of this unit
     std::unordered_map<int, std::string> m_hostnames;
     UnitType m_type = UNDEFINED;
     std::string m_configPath = "config.json";
+    std::string m_configHostname; // "hostname" of this rank in the config, as the peers' getPairHost() see it
+    std::string m_networkDevice; // "ibdev" of this rank in the config
+
+    int m_numaNode = -1;
+    bool m_memoryBound = false;
 };
 
 #endif // UNIT_H
\ No newline at end of file